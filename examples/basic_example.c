@@ -44,10 +44,12 @@ int main(void) {
     // Load animations
     int animCount;
     ModelAnimation *animations = LoadModelAnimations("/rd/MyModel.gltf", &animCount);
+    Anim4dcBakedModel *baked = NULL;
     
     if (animCount > 0) {
         // Bake skeletal animations to vertex keyframes
-        if (Anim4dcBakeVertexAnimations(myModel, animations, animCount)) {
+        baked = Anim4dcBakeVertexAnimations(myModel, animations, animCount);
+        if (baked) {
             printf("Successfully baked %d animations\n", animCount);
         } else {
             printf("Failed to bake animations\n");
@@ -67,10 +69,10 @@ int main(void) {
         float deltaTime = GetFrameTime();
         
         // Update animation
-        Anim4dcUpdateAnimation(deltaTime);
+        Anim4dcUpdateAnimation(baked, deltaTime);
         
         // Get interpolated vertices
-        float *animatedVertices = Anim4dcGetInterpolatedVertices();
+        float *animatedVertices = baked ? Anim4dcGetInterpolatedVertices(baked) : NULL;
         
         // Update model mesh with animated vertices (if available)
         if (animatedVertices && myModel.meshCount > 0) {
@@ -98,8 +100,8 @@ int main(void) {
         DrawFPS(10, 30);
         
         // Show current animation info
-        int currentAnim = Anim4dcGetCurrentAnimation();
-        float animTime = Anim4dcGetAnimationTime();
+        int currentAnim = Anim4dcGetCurrentAnimation(baked);
+        float animTime = Anim4dcGetAnimationTime(baked);
         DrawText(TextFormat("Animation: %d | Time: %.2f", currentAnim, animTime), 10, 50, 12, WHITE);
         
         EndDrawing();
@@ -111,6 +113,7 @@ int main(void) {
     }
     UnloadModel(myModel);
     
+    Anim4dcUnloadBakedModel(baked);
     Anim4dcShutdown();
     CloseWindow();
     
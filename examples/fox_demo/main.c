@@ -7,9 +7,13 @@
 *
 *   FEATURES DEMONSTRATED:
 *       - Vertex animation baking from skeletal data
+*       - Pre-baked .a4d loading (make fox_a4d) with runtime baking fallback
 *       - Multi-format model loading (GLTF fallback chain)
 *       - LOD-based performance optimization
 *       - Batch rendering with 25 animated fox instances
+*       - Per-instance animation clocks (staggered phases)
+*       - Per-instance crossfades between animations
+*       - Pose cache sharing interpolated vertices between instances
 *       - Real-time performance monitoring
 *
 *   CONTROLS:
@@ -55,6 +59,7 @@ KOS_INIT_FLAGS(INIT_DEFAULT | INIT_MALLOCSTATS);
 #define MAX_FOX_INSTANCES 1      // Flycast target (reduce to 12 for real hardware)
 #define CAMERA_DISTANCE 200.0f
 #define ROTATION_SPEED 30.0f
+#define CROSSFADE_TIME 0.3f      // Seconds to blend between animations
 
 // Use KOS controller constants directly
 #define BUTTON_A CONT_A
@@ -72,6 +77,7 @@ typedef struct {
     Model foxModel;
     ModelAnimation *foxAnimations;
     int foxAnimationCount;
+    Anim4dcBakedModel *foxBaked;
     
     Anim4dcModelInstance foxInstances[MAX_FOX_INSTANCES];
     int activeInstances;
@@ -113,6 +119,7 @@ void InitializeFoxInstances(void) {
         demo.foxInstances[i].scale = 1.0f;
         demo.foxInstances[i].animationIndex = 0;  // Start with Survey
         demo.foxInstances[i].animationTime = (float)i * 0.1f;  // Stagger animations
+        demo.foxInstances[i].fadeDuration = 0.0f;  // Not crossfading
         demo.foxInstances[i].lodLevel = ANIM4DC_LOD_NEAR;
         demo.foxInstances[i].visible = true;
         demo.foxInstances[i].distanceSquared = 0.0f;
@@ -135,11 +142,11 @@ void HandleInput(void) {
     // Toggle animation with A button
     if (pressed & BUTTON_A) {
         demo.currentAnimationIndex = (demo.currentAnimationIndex + 1) % animationCount;
-        Anim4dcSetAnimationByName(animationNames[demo.currentAnimationIndex]);
         
-        // Update all instance animations
+        // Crossfade every instance into the new animation, keeping the staggered phases
         for (int i = 0; i < demo.activeInstances; i++) {
-            demo.foxInstances[i].animationIndex = demo.currentAnimationIndex;
+            Anim4dcCrossfadeInstance(demo.foxBaked, &demo.foxInstances[i], demo.currentAnimationIndex, CROSSFADE_TIME);
+            demo.foxInstances[i].animationTime = (float)i * 0.1f;
         }
         
         snprintf(demo.statusMessage, sizeof(demo.statusMessage), 
@@ -182,22 +189,26 @@ void UpdateDemoCamera(void) {
 void RenderDebugInfo(void) {
     if (!demo.showDebug) return;
     
-    Anim4dcStats stats = Anim4dcGetStats();
+    Anim4dcStats stats = Anim4dcGetStats(demo.foxBaked);
+    int lodChanges = 0;
+    for (int i = 0; i <= ANIM4DC_LOD_CULLED; i++) lodChanges += stats.lodTransitions[i];
     
     char debugText[512];
     snprintf(debugText, sizeof(debugText),
         "Anim4DC Fox Demo v%s\n"
         "FPS: %.1f | Instances: %d/%d\n"
-        "Visible: %d | Culled: %d\n"
+        "Visible: %d | Culled: %d + %d off-screen | LOD changes: %d\n"
+        "Pose cache: %d hits / %d misses | Uploads: %d | Pose verts: %d\n"
         "Animation: %s (%.2fs)\n"
-        "Memory: %d KB\n"
+        "Memory: %d KB | Kernel: %s\n"
         "Controls: A=Anim, B=Debug, Start=Pause",
         Anim4dcGetVersion(),
         demo.fps, demo.activeInstances, MAX_FOX_INSTANCES,
-        stats.visibleInstances, stats.culledInstances,
+        stats.visibleInstances, stats.culledInstances, stats.frustumCulledInstances, lodChanges,
+        stats.poseCacheHits, stats.poseCacheMisses, stats.meshUploads, stats.poseVertices,
         animationNames[demo.currentAnimationIndex],
-        Anim4dcGetAnimationTime(),
-        stats.memoryUsageKB
+        demo.foxInstances[0].animationTime,
+        stats.memoryUsageKB, Anim4dcGetKernelName(Anim4dcGetKernel())
     );
     
     DrawText(debugText, 10, 10, 10, WHITE);
@@ -226,6 +237,12 @@ int main(void) {
         return -1;
     }
     
+    // Fall back to the reference interpolation if the fast kernel does not match it
+    if (!Anim4dcValidateKernels()) {
+        printf("Fox Demo: Kernel validation failed, using the scalar kernel\n");
+        Anim4dcSetKernel(ANIM4DC_KERNEL_SCALAR);
+    }
+    
     // Setup camera
     demo.camera.position = (Vector3){ CAMERA_DISTANCE, 50.0f, 0.0f };
     demo.camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
@@ -244,14 +261,36 @@ int main(void) {
     } else {
         printf("Fox Demo: Fox model loaded successfully\n");
         
-        // Load animations
-        demo.foxAnimations = LoadModelAnimations("/rd/Fox.gltf", &demo.foxAnimationCount);
+        // Pre-baked animations skip skeletal loading and skinning entirely
+        demo.foxBaked = Anim4dcLoadBaked("/rd/Fox.a4d");
+        if (demo.foxBaked && !Anim4dcMatchModelLayout(demo.foxBaked, &demo.foxModel)) {
+            Anim4dcUnloadBakedModel(demo.foxBaked);
+            demo.foxBaked = NULL;
+        }
         
-        if (demo.foxAnimationCount > 0) {
+        if (demo.foxBaked) {
+            printf("Fox Demo: Loaded pre-baked vertex animations\n");
+            InitializeFoxInstances();
+            demo.initialized = true;
+            strcpy(demo.statusMessage, "Fox Demo Ready - Press A to change animation");
+        } else {
+            // Load animations
+            demo.foxAnimations = LoadModelAnimations("/rd/Fox.gltf", &demo.foxAnimationCount);
+        }
+        
+        if (!demo.initialized && demo.foxAnimationCount > 0) {
             printf("Fox Demo: Loaded %d animations\n", demo.foxAnimationCount);
             
-            // Bake vertex animations
-            if (Anim4dcBakeVertexAnimations(demo.foxModel, demo.foxAnimations, demo.foxAnimationCount)) {
+            // Bake vertex animations for the welded mesh, with lighter meshes for the distant LOD levels
+            // and each clip's near-still vertices left at the bind pose
+            Anim4dcBakeOptions options = Anim4dcGetDefaultBakeOptions();
+            options.weldVertices = true;
+            options.staticThreshold = 0.01f;
+            options.lodVertexCounts[0] = 600;
+            options.lodVertexCounts[1] = 300;
+            options.lodVertexCounts[2] = 120;
+            demo.foxBaked = Anim4dcBakeVertexAnimationsEx(demo.foxModel, demo.foxAnimations, demo.foxAnimationCount, options, NULL);
+            if (demo.foxBaked) {
                 printf("Fox Demo: Vertex animations baked successfully\n");
                 InitializeFoxInstances();
                 demo.initialized = true;
@@ -260,10 +299,13 @@ int main(void) {
                 printf("Fox Demo: Failed to bake vertex animations\n");
                 strcpy(demo.statusMessage, "ERROR: Animation baking failed");
             }
-        } else {
+        } else if (!demo.initialized) {
             printf("Fox Demo: No animations found\n");
             strcpy(demo.statusMessage, "ERROR: No animations found in model");
         }
+        
+        // Decimated meshes baked for MID/FAR/FROZEN need their own render models
+        if (demo.initialized) Anim4dcLoadMeshVariants(demo.foxBaked, demo.foxModel);
     }
     
     // Main loop
@@ -287,10 +329,11 @@ int main(void) {
         
         // Update animations
         if (demo.initialized && !demo.animationPaused) {
-            Anim4dcUpdateAnimation(deltaTime);
-            
             // Update LOD for all instances
-            Anim4dcUpdateInstanceLOD(demo.foxInstances, demo.activeInstances, demo.camera.position);
+            Anim4dcUpdateInstanceLOD(demo.foxBaked, demo.foxInstances, demo.activeInstances, demo.camera);
+            
+            // Advance each instance's own clock
+            Anim4dcUpdateInstances(demo.foxBaked, demo.foxInstances, demo.activeInstances, deltaTime);
         }
         
         // Render
@@ -303,18 +346,18 @@ int main(void) {
         DrawGrid(20, 10.0f);
         
         if (demo.initialized) {
-            // Update model vertices with current animation frame
-            float *interpolatedVertices = Anim4dcGetInterpolatedVertices();
-            if (interpolatedVertices && demo.foxModel.meshCount > 0) {
-                // Copy interpolated vertices to model
-                memcpy(demo.foxModel.meshes[0].vertices, interpolatedVertices,
-                       demo.foxModel.meshes[0].vertexCount * 3 * sizeof(float));
-                UploadMesh(&demo.foxModel.meshes[0], false);
-            }
+            float *uploadedPose = NULL;
             
             // Render all fox instances
             for (int i = 0; i < demo.activeInstances; i++) {
                 if (demo.foxInstances[i].visible) {
+                    // Update every animated mesh with this instance's animation frame,
+                    // shared poses are only uploaded when they change
+                    float *pose = Anim4dcGetInstancePose(demo.foxBaked, &demo.foxInstances[i]);
+                    if (!pose || pose != uploadedPose) {
+                        if (Anim4dcApplyInstancePose(demo.foxBaked, &demo.foxModel, &demo.foxInstances[i])) uploadedPose = pose;
+                    }
+                    
                     Vector3 pos = demo.foxInstances[i].position;
                     Vector3 rot = demo.foxInstances[i].rotation;
                     float scale = demo.foxInstances[i].scale;
@@ -336,7 +379,8 @@ int main(void) {
                         default: modelColor = DARKGRAY; break;
                     }
                     
-                    DrawModel(demo.foxModel, pos, scale, modelColor);
+                    // Distant instances may show a decimated mesh variant
+                    DrawModel(Anim4dcGetInstanceModel(demo.foxBaked, demo.foxModel, &demo.foxInstances[i]), pos, scale, modelColor);
                 }
             }
         }
@@ -355,6 +399,7 @@ int main(void) {
     }
     UnloadModel(demo.foxModel);
     
+    Anim4dcUnloadBakedModel(demo.foxBaked);
     Anim4dcShutdown();  
     CloseWindow();
     
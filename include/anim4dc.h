@@ -1,6 +1,6 @@
 /**********************************************************************************************
 *
-*   anim4dc v1.0 - Dreamcast Raylib Animation Plugin
+*   anim4dc v2.0 - Dreamcast Raylib Animation Plugin
 *
 *   A high-performance vertex animation system optimized for Sega Dreamcast hardware
 *   
@@ -20,6 +20,9 @@
 *       - KallistiOS
 *       - GLdc
 *
+*   NOTE: Without _arch_dreamcast (host builds, e.g. tools/anim4dc_bake) raylib is
+*         included as <raylib.h> and KallistiOS is not required
+*
 *   LICENSE: MIT License
 *
 *   Copyright (c) 2024 Anim4DC Team
@@ -29,32 +32,78 @@
 #ifndef ANIM4DC_H
 #define ANIM4DC_H
 
-#include <raylib/raylib.h>
-#include <raylib/raymath.h>
+#if defined(_arch_dreamcast)
+    #include <raylib/raylib.h>
+    #include <raylib/raymath.h>
+#else
+    #include <raylib.h>             // Host builds (offline baker)
+    #include <raymath.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-#define ANIM4DC_VERSION_MAJOR       1
+#define ANIM4DC_VERSION_MAJOR       2
 #define ANIM4DC_VERSION_MINOR       0
 #define ANIM4DC_VERSION_PATCH       0
-#define ANIM4DC_VERSION             "1.0.0"
+#define ANIM4DC_VERSION             "2.0.0"
 
 // Memory optimization constants for Dreamcast (16MB total RAM)
-#define ANIM4DC_MAX_KEYFRAMES       20          // Maximum keyframes per animation
-#define ANIM4DC_MAX_ANIMATIONS      8           // Maximum animations per model
 #define ANIM4DC_MAX_INSTANCES       25          // Maximum model instances for benchmarking
 #define ANIM4DC_MAX_NAME_LENGTH     32          // Animation name length
+#define ANIM4DC_MAX_MESHES          8           // Maximum skinned meshes baked per model
+#define ANIM4DC_MAX_MESH_VARIANTS   4           // Full resolution plus a decimated mesh for each of MID, FAR and FROZEN
+#define ANIM4DC_DECIMATE_MIN_DOT    0.2f        // Min cosine between a triangle's normal before and after an edge collapse
+#define ANIM4DC_VERTEX_CACHE_SIZE   32          // Post-transform cache entries simulated when ordering welded triangles
+#define ANIM4DC_STATIC_EPSILON      1e-5f       // Max bind pose deviation of a mesh skipped as static
+#define ANIM4DC_SPARSE_MAX_MOVING   0.9f        // Max fraction of moving vertices an animation is stored sparse with
+#define ANIM4DC_MAX_BASIS_SHAPES    16          // Max basis shapes of a basis compressed animation
+#define ANIM4DC_RIGID_MIN_VERTICES  8           // Min vertices of a rigid segment, fewer are cheaper as per-vertex keyframes
+#define ANIM4DC_RIGID_MIN_WEIGHT    0.99f       // Min bone weight of the vertices a rigid segment's transforms are fitted to
+#define ANIM4DC_RIGID_BLEND_CHUNK   64          // Vertices crossfaded per pass when a keyframe pair has rigid segments
+#define ANIM4DC_ADAPTIVE_MAX_SPAN   32          // Max source frames covered by one adaptive keyframe segment
+#define ANIM4DC_SOURCE_FRAME_RATE   (1000.0f / 17.0f)   // raylib samples glTF/M3D clips every 17 ms
+#define ANIM4DC_POSE_CACHE_SIZE     8           // Interpolated poses shared between instances per frame
+#define ANIM4DC_POSE_QUANTUM        (1.0f / 30.0f)  // Default pose cache time step in seconds
+#define ANIM4DC_KERNEL_EPSILON      1e-6f       // Max relative deviation of a kernel from the scalar reference
 
-// LOD system constants (squared distances to avoid sqrt calculations)
+// Baked animation file (.a4d) format
+#define ANIM4DC_BAKED_MAGIC         "A4DC"      // File identifier
+#define ANIM4DC_BAKED_VERSION       8           // Bump on any layout change
+#define ANIM4DC_BAKED_ALIGNMENT     32          // Keyframe vertex block and model arena alignment (SH4 cache line)
+
+// LOD system constants (squared distances to avoid sqrt calculations), the default LOD policy
 #define ANIM4DC_LOD_NEAR_DIST2      (80.0f * 80.0f)    // Full detail animation
 #define ANIM4DC_LOD_MID_DIST2       (120.0f * 120.0f)   // Reduced animation rate
 #define ANIM4DC_LOD_FAR_DIST2       (160.0f * 160.0f)   // Minimal animation
-#define ANIM4DC_LOD_CULL_DIST2      (200.0f * 200.0f)   // No rendering/animation
+#define ANIM4DC_LOD_CULL_DIST2      (200.0f * 200.0f)   // No rendering/animation, frozen up to here
+
+// LOD hysteresis margins in world units, an instance only crosses a band limit once it is this far past it
+#define ANIM4DC_LOD_NEAR_HYSTERESIS 4.0f        // Around the NEAR/MID limit
+#define ANIM4DC_LOD_MID_HYSTERESIS  4.0f        // Around the MID/FAR limit
+#define ANIM4DC_LOD_FAR_HYSTERESIS  4.0f        // Around the FAR/FROZEN limit
+#define ANIM4DC_LOD_CULL_HYSTERESIS 4.0f        // Around the FROZEN/CULLED limit
+
+// Screen size LOD policy limits, projected bounding sphere radius in pixels (see Anim4dcGetScreenSizeLodPolicy)
+#define ANIM4DC_LOD_NEAR_PIXELS     40.0f       // Full detail down to this size
+#define ANIM4DC_LOD_MID_PIXELS      20.0f       // Reduced animation rate down to this size
+#define ANIM4DC_LOD_FAR_PIXELS      10.0f       // Minimal animation down to this size
+#define ANIM4DC_LOD_CULL_PIXELS     5.0f        // Frozen down to this size, culled below
+#define ANIM4DC_LOD_PIXEL_HYSTERESIS 0.1f       // Screen size margins as a fraction of each limit
+
+// View frustum culling, clip distances match raylib's BeginMode3D() defaults
+#define ANIM4DC_FRUSTUM_NEAR        0.01f       // Near clip plane distance
+#define ANIM4DC_FRUSTUM_FAR         1000.0f     // Far clip plane distance
+
+// Spatial grid for LOD classification of large crowds
+#define ANIM4DC_GRID_CELL_SIZE      40.0f       // Default cell edge, the width of the MID/FAR/FROZEN bands
+#define ANIM4DC_GRID_MAX_LOAD       0.75f       // Claimed cells per hash slot before emptied cells are dropped
+#define ANIM4DC_LOD_BATCH_SIZE      64          // Instances gathered per batch when classifying Anim4dcModelInstance arrays
 
 // LOD animation speed multipliers
 #define ANIM4DC_LOD_NEAR_SPEED      1.0f        // Full speed
@@ -62,6 +111,12 @@
 #define ANIM4DC_LOD_FAR_SPEED       0.25f       // Quarter speed
 #define ANIM4DC_LOD_FROZEN_SPEED    0.0f        // No animation advance
 
+// LOD pose update intervals in Anim4dcUpdateInstances calls, staggered across instances
+#define ANIM4DC_LOD_NEAR_INTERVAL   1           // Every frame
+#define ANIM4DC_LOD_MID_INTERVAL    2           // Every 2nd frame
+#define ANIM4DC_LOD_FAR_INTERVAL    4           // Every 4th frame
+#define ANIM4DC_LOD_FROZEN_INTERVAL 0           // Never, the last pose is kept
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
@@ -75,32 +130,90 @@ typedef enum {
     ANIM4DC_LOD_CULLED          // Not rendered
 } Anim4dcLodLevel;
 
+// What LOD band limits measure
+typedef enum {
+    ANIM4DC_LOD_POLICY_DISTANCE = 0,    // Camera distance in world units
+    ANIM4DC_LOD_POLICY_SCREEN_SIZE      // Projected bounding sphere radius in pixels (instance scale, FOV and viewport height)
+} Anim4dcLodPolicyType;
+
+// Vertex interpolation kernels, Anim4dcInit() selects the fastest one supported
+typedef enum {
+    ANIM4DC_KERNEL_SCALAR = 0,  // Reference loop, one vertex per iteration
+    ANIM4DC_KERNEL_UNROLLED4,   // 4 floats per step with cache line prefetch (plain C unroll)
+    ANIM4DC_KERNEL_SSE,         // x86 SSE, 4 floats per instruction (host builds)
+    ANIM4DC_KERNEL_AVX,         // x86 AVX, 8 floats per instruction (host builds)
+    ANIM4DC_KERNEL_COUNT
+} Anim4dcKernel;
+
+// Keyframe vertex storage
+typedef enum {
+    ANIM4DC_STORAGE_FLOAT = 0,          // 32-bit float positions (12 bytes per vertex)
+    ANIM4DC_STORAGE_INT16_ANIMATION,    // 16-bit positions quantized to one box per animation (6 bytes per vertex)
+    ANIM4DC_STORAGE_INT16_KEYFRAME      // 16-bit positions quantized to one box per keyframe (6 bytes per vertex)
+} Anim4dcStorageMode;
+
 // Vertex keyframe for baked animations
 typedef struct Anim4dcVertexKeyframe {
-    float *vertices;            // Vertex positions for this keyframe
-    int vertexCount;           // Number of vertices
+    float *vertices;            // Vertex positions for this keyframe (ANIM4DC_STORAGE_FLOAT)
+    short *quantized;          // Quantized positions, position = offset + quantized * scale (INT16 storage)
+    Vector3 offset;            // Dequantization offset (bounding box center)
+    Vector3 scale;             // Dequantization scale (bounding box half extent / 32767)
+    int vertexCount;           // Number of vertices stored
     float timestamp;           // Time for this keyframe in seconds
+    const float *rest;         // Rest pose of every baked vertex, stored positions are deltas from it (NULL = absolute)
+    const uint32_t *moving;    // Baked vertex of each stored delta (ascending), the others stay at rest (NULL = all stored)
+    const float *basis;        // Mean then basisCount shapes of vertexCount positions, stored position = mean +
+                               // coefficients-weighted sum of the shapes (NULL = per keyframe positions)
+    const float *coefficients; // Weight of each basis shape for this keyframe
+    int basisCount;            // Basis shapes of a basis compressed keyframe
+    const float *transforms;   // Row-major 3x4 transform of the rest pose per rigid segment (NULL = no rigid segments)
+    const uint32_t *segmentVertices; // Vertices of the rigid segments, grouped by segment (ascending in each)
+    const uint32_t *segmentStarts;   // segmentCount + 1 offsets of the segments into segmentVertices
+    int segmentCount;          // Rigid segments, their vertices are neither stored nor at rest
 } Anim4dcVertexKeyframe;
 
 // Vertex animation structure
 typedef struct Anim4dcVertexAnimation {
     char name[ANIM4DC_MAX_NAME_LENGTH];                 // Animation name
-    Anim4dcVertexKeyframe keyframes[ANIM4DC_MAX_KEYFRAMES]; // Keyframe data
+    Anim4dcVertexKeyframe *keyframes;                   // Keyframe data (inside the model arena)
     int keyframeCount;                                  // Number of keyframes
     float duration;                                     // Total animation duration
+    float keyframeInterval;                             // Spacing of uniformly sampled keyframes (0 = non-uniform)
     bool looping;                                      // Should animation loop?
+    uint32_t *movingVertices;                           // Vertices the keyframes store deltas for (ascending, NULL = dense)
+    int movingCount;                                    // Entries in movingVertices
+    float *basis;                                       // Mean and basis shapes of a compressed animation (NULL = per keyframe positions)
+    float *coefficients;                                // basisCount shape weights per keyframe
+    int basisCount;                                     // Basis shapes
+    uint32_t *segmentVertices;                          // Vertices moving rigidly, grouped by segment (NULL = none)
+    uint32_t *segmentStarts;                            // segmentCount + 1 offsets into segmentVertices, which follow them
+    float *transforms;                                  // segmentCount 3x4 transforms per keyframe
+    int segmentCount;                                   // Rigid segments
 } Anim4dcVertexAnimation;
 
-// Animation system state
-typedef struct Anim4dcAnimationSystem {
-    Anim4dcVertexAnimation animations[ANIM4DC_MAX_ANIMATIONS];  // Baked animations
-    int animationCount;                                         // Number of animations
-    int currentAnimation;                                       // Current animation index
-    float currentTime;                                         // Current playback time
-    float *interpolationBuffer;                                // Buffer for interpolated vertices
-    int vertexCount;                                          // Number of vertices per keyframe
-    bool initialized;                                         // System initialization state
-} Anim4dcAnimationSystem;
+// Skinned mesh's block of vertices inside every keyframe
+typedef struct Anim4dcMeshRange {
+    int meshIndex;              // Index into model.meshes
+    int vertexOffset;           // First vertex of this mesh in each keyframe
+    int vertexCount;            // Vertices of this mesh
+    int sourceVertexCount;      // Vertices of the mesh as loaded, before welding (= vertexCount if not welded)
+} Anim4dcMeshRange;
+
+// Shared interpolated pose, keyed by animation and quantized time
+typedef struct Anim4dcPoseCacheEntry {
+    float *vertices;            // Interpolated vertex positions
+    int animationIndex;        // Animation of the cached pose (-1 = empty)
+    int timeStep;              // Playback time / pose quantum
+    int meshVariant;           // Mesh variant the pose was interpolated for (0 = full resolution)
+    unsigned int lastUsedFrame; // Instance update that last referenced this pose
+} Anim4dcPoseCacheEntry;
+
+// Baked model handle: one model's animations, playback state and pose cache (opaque)
+// Several baked models can be live at once, each is freed on its own with Anim4dcUnloadBakedModel()
+typedef struct Anim4dcBakedModel Anim4dcBakedModel;
+
+// Spatial hash grid over an instance array's positions (opaque), see Anim4dcUpdateInstanceLODGrid()
+typedef struct Anim4dcSpatialGrid Anim4dcSpatialGrid;
 
 // Model instance for batch rendering and LOD
 typedef struct Anim4dcModelInstance {
@@ -109,18 +222,97 @@ typedef struct Anim4dcModelInstance {
     float scale;               // Uniform scale
     int animationIndex;        // Which animation to play (-1 = none)
     float animationTime;       // Current animation time
+    int currentKeyframe;       // Keyframe pair of the displayed pose, resolved by Anim4dcUpdateInstances
+    int nextKeyframe;
+    float blendFactor;         // Interpolation factor between currentKeyframe and nextKeyframe
+    int fadeAnimation;         // Animation fading out of the displayed pose, see Anim4dcCrossfadeInstance
+    float fadeTime;            // Playback time of the animation fading out
+    int fadeKeyframe;          // Keyframe pair of the animation fading out, resolved with the displayed pose
+    int fadeNextKeyframe;
+    float fadeBlendFactor;     // Interpolation factor between fadeKeyframe and fadeNextKeyframe
+    float fadeElapsed;         // Time since the crossfade started
+    float fadeDuration;        // Crossfade length in seconds (0 = not fading)
+    float poseTime;            // Playback time of the displayed pose, refreshed at the LOD update interval
+    int poseAnimation;         // Animation of the displayed pose
+    unsigned int poseFrame;    // Update that last refreshed the pose (0 = never)
+    int poseIndex;             // Shared pose cache entry (-1 = interpolated on its own)
+    int meshVariant;           // Mesh of the displayed pose (0 = full resolution, else the LOD level it was decimated for)
     Anim4dcLodLevel lodLevel;  // Current LOD level
-    bool visible;              // Should be rendered this frame
-    float distanceSquared;     // Distance from camera (squared)
+    bool visible;              // Should be rendered this frame (in range and inside the camera frustum)
+    float distanceSquared;     // Distance from camera (squared, not refreshed for instances classified per grid cell)
 } Anim4dcModelInstance;
 
-// Performance statistics
+// Structure-of-arrays instance storage for the LOD pass over large crowds (see Anim4dcCreateInstanceArrays)
+// Positions and scale are inputs, the rest is written by Anim4dcUpdateInstanceArraysLOD
+typedef struct Anim4dcInstanceArrays {
+    float *x;                   // World positions, one array per axis
+    float *y;
+    float *z;
+    float *scale;               // Uniform scale
+    float *distanceSquared;     // Distance from camera (squared)
+    unsigned char *lodLevel;    // Anim4dcLodLevel of each instance (the previous one feeds the hysteresis)
+    unsigned char *visible;     // 1 = in range and inside the camera frustum
+    int count;                  // Instances in use
+    int capacity;               // Instances allocated per array
+    void *allocation;           // One block behind every array
+} Anim4dcInstanceArrays;
+
+// LOD band limits, global (Anim4dcSetLodPolicy) or per baked model (Anim4dcSetModelLodPolicy)
+typedef struct Anim4dcLodPolicy {
+    Anim4dcLodPolicyType type;  // What the limits measure
+    float limits[4];            // NEAR/MID, MID/FAR, FAR/FROZEN and FROZEN/CULLED limits (distances rise, sizes fall)
+    float hysteresis[4];        // Margins around each limit in the same unit (clamped to half the narrower neighbouring band)
+    int viewportWidth;          // Render target width in pixels for the frustum aspect (0 = GetScreenWidth())
+    int viewportHeight;         // Render target height in pixels for screen sizes and the frustum aspect (0 = GetScreenHeight())
+} Anim4dcLodPolicy;
+
+// Keyframe baking options
+typedef struct Anim4dcBakeOptions {
+    float maxError;            // Max per-vertex position error for adaptive keyframe selection (0 = fixed stride)
+    Anim4dcStorageMode storage; // Keyframe vertex storage
+    float sourceFrameRate;     // Rate the ModelAnimation frames were sampled at (0 = ANIM4DC_SOURCE_FRAME_RATE)
+    float targetFrameRate;     // Resample to this rate before keyframe selection, fixed stride keeps every sample
+                               // (0 = source frames, fixed stride keeps every 4th/8th)
+    int lodVertexCounts[3];    // Target vertices of decimated MID, FAR and FROZEN meshes (0 = no mesh variant for the level)
+    bool weldVertices;         // Weld, index and cache order the model's skinned meshes in place before baking
+    float staticThreshold;     // Max bind pose deviation of a vertex dropped from an animation's keyframes as static,
+                               // the others are stored as deltas from the bind pose (0 = absolute keyframes)
+    float basisMaxError;       // Max per-vertex error of basis (PCA) compression, each animation keeps the fewest
+                               // basis shapes that meet it if that takes less memory (0 = per keyframe positions)
+    float rigidMaxError;       // Max per-vertex error of rigid segments: vertices moving with their dominant bone are
+                               // stored as one 3x4 transform per segment and keyframe (0 = per-vertex keyframes)
+} Anim4dcBakeOptions;
+
+// Per-animation baking results
+typedef struct Anim4dcBakeReport {
+    int sourceFrames;          // Frames in the source skeletal animation
+    float duration;            // Clip length in seconds from the source frame rate
+    int keyframeCount;         // Keyframes kept
+    float maxError;            // Worst per-vertex position error of the interpolated playback
+    float quantizationError;   // Worst per-vertex error added by INT16 storage (0 for float)
+    int movingVertices;        // Vertices stored per keyframe (fewer than baked when static ones are dropped)
+    int basisShapes;           // Basis shapes kept by basis compression (0 = per keyframe positions)
+    float basisError;          // Worst per-vertex error added by basis compression
+    int keyframeBytes;         // Bytes of keyframe data as stored (positions, or basis shapes and coefficients)
+    int rigidSegments;         // Rigid segments found (0 = per-vertex keyframes)
+    int rigidVertices;         // Vertices moved by segment transforms instead of keyframes
+    float rigidError;          // Worst per-vertex error added by the segment transforms
+} Anim4dcBakeReport;
+
+// Performance statistics (per baked model)
 typedef struct Anim4dcStats {
     int visibleInstances;       // Number of rendered instances
-    int culledInstances;        // Number of culled instances  
-    int animationUpdates;       // Number of animation updates this frame
+    int culledInstances;        // Instances past the LOD policy's cull limit
+    int frustumCulledInstances; // Instances in range but outside the camera frustum
+    int lodInstanceTests;       // Instances classified one by one this frame (the rest by spatial grid cell)
+    int lodTransitions[ANIM4DC_LOD_CULLED + 1]; // Instances that entered each Anim4dcLodLevel this frame
+    int animationUpdates;       // Instance poses refreshed this frame (LOD intervals skip the rest)
+    int poseCacheHits;          // Instances that reused a shared pose this frame
+    int poseCacheMisses;        // Poses interpolated this frame (or instances left without one)
+    int meshUploads;            // Mesh position uploads this frame
+    int poseVertices;           // Vertices interpolated for instance poses this frame (mesh variants cut this)
     float averageFPS;          // Average FPS over recent frames
-    int memoryUsageKB;         // Approximate memory usage in KB
+    int memoryUsageKB;         // Approximate memory usage of the baked model in KB
 } Anim4dcStats;
 
 //----------------------------------------------------------------------------------
@@ -143,55 +335,229 @@ extern "C" {            // Prevents name mangling of functions
 // Initialize the animation system
 bool Anim4dcInit(void);
 
-// Shutdown and cleanup the animation system
+// Shutdown and cleanup the animation system, unloading any baked model still live
 void Anim4dcShutdown(void);
 
 // Check if a model and its animations are compatible for vertex baking
 bool Anim4dcCheckModelCompatibility(Model model, ModelAnimation *animations, int animationCount);
 
-// Bake skeletal animations into vertex keyframes for optimal playback
-bool Anim4dcBakeVertexAnimations(Model model, ModelAnimation *animations, int animationCount);
+// Bake skeletal animations into vertex keyframes for optimal playback (NULL on failure)
+Anim4dcBakedModel *Anim4dcBakeVertexAnimations(Model model, ModelAnimation *animations, int animationCount);
+
+// Bake with explicit options, reports (optional, one per animation) receive keyframe count and error
+Anim4dcBakedModel *Anim4dcBakeVertexAnimationsEx(Model model, ModelAnimation *animations, int animationCount, Anim4dcBakeOptions options, Anim4dcBakeReport *reports);
+
+// Get default baking options (fixed keyframe stride)
+Anim4dcBakeOptions Anim4dcGetDefaultBakeOptions(void);
+
+// Get the rate raylib sampled a model file's animation frames at (IQM: the file's own frame rate)
+float Anim4dcGetSourceFrameRate(const char *fileName);
+
+// Free a baked model and everything it owns
+void Anim4dcUnloadBakedModel(Anim4dcBakedModel *baked);
+
+// Save baked animations to a .a4d file (see tools/anim4dc_bake)
+bool Anim4dcSaveBaked(const Anim4dcBakedModel *baked, const char *fileName);
+
+// Load baked animations from a .a4d file in a single read, no model or skinning required
+Anim4dcBakedModel *Anim4dcLoadBaked(const char *fileName);
+
+// Load baked animations from .a4d data in memory, keyframes point into data (must outlive the baked model)
+Anim4dcBakedModel *Anim4dcLoadBakedFromMemory(void *data, int dataSize);
 
 // Update animation playback (call once per frame)
-void Anim4dcUpdateAnimation(float deltaTime);
+void Anim4dcUpdateAnimation(Anim4dcBakedModel *baked, float deltaTime);
+
+// Get the current interpolated vertices for rendering (the registered destination if any)
+float *Anim4dcGetInterpolatedVertices(const Anim4dcBakedModel *baked);
 
-// Get the current interpolated vertices for rendering
-float *Anim4dcGetInterpolatedVertices(void);
+// Interpolate straight into a caller-owned buffer, stride in bytes between positions (0 = packed)
+// The internal buffer is released, NULL restores it
+bool Anim4dcSetOutputBuffer(Anim4dcBakedModel *baked, float *destination, int stride);
+
+// Interpolate straight into a mesh's vertex array, no copy needed before upload (single baked mesh)
+bool Anim4dcSetOutputMesh(Anim4dcBakedModel *baked, Mesh *mesh);
+
+// Interpolate straight into every baked mesh of a model
+bool Anim4dcSetOutputModel(Anim4dcBakedModel *baked, Model *model);
+
+// Check that a model's meshes match the baked vertex layout
+bool Anim4dcCheckModelLayout(const Anim4dcBakedModel *baked, Model model);
+
+// Weld a freshly loaded model's meshes the way they were welded for baking, then check its layout
+bool Anim4dcMatchModelLayout(const Anim4dcBakedModel *baked, Model *model);
+
+// Get the number of vertices per baked keyframe
+int Anim4dcGetVertexCount(const Anim4dcBakedModel *baked);
+
+// Get the number of baked animations
+int Anim4dcGetAnimationCount(const Anim4dcBakedModel *baked);
 
 //------------------------------------------------------------------------------------
 // Animation Control Functions  
 //------------------------------------------------------------------------------------
 
 // Set the current animation by index
-bool Anim4dcSetAnimation(int animationIndex);
+bool Anim4dcSetAnimation(Anim4dcBakedModel *baked, int animationIndex);
 
 // Set the current animation by name
-bool Anim4dcSetAnimationByName(const char *animationName);
+bool Anim4dcSetAnimationByName(Anim4dcBakedModel *baked, const char *animationName);
+
+// Crossfade from the current animation to another over fadeDuration seconds (0 = switch at once)
+bool Anim4dcCrossfadeAnimation(Anim4dcBakedModel *baked, int animationIndex, float fadeDuration);
+
+// Crossfade to an animation by name
+bool Anim4dcCrossfadeAnimationByName(Anim4dcBakedModel *baked, const char *animationName, float fadeDuration);
 
 // Get the current animation index
-int Anim4dcGetCurrentAnimation(void);
+int Anim4dcGetCurrentAnimation(const Anim4dcBakedModel *baked);
 
 // Get the current animation time
-float Anim4dcGetAnimationTime(void);
+float Anim4dcGetAnimationTime(const Anim4dcBakedModel *baked);
 
 // Set the animation time (for scrubbing)
-void Anim4dcSetAnimationTime(float time);
+void Anim4dcSetAnimationTime(Anim4dcBakedModel *baked, float time);
 
-// Pause/unpause animation playback
-void Anim4dcSetAnimationPaused(bool paused);
+// Pause/unpause the global playback (Anim4dcUpdateAnimation keeps writing the held pose)
+void Anim4dcSetAnimationPaused(Anim4dcBakedModel *baked, bool paused);
 
 //------------------------------------------------------------------------------------
 // Batch Rendering and LOD Functions
 //------------------------------------------------------------------------------------
 
-// Update LOD levels for all instances based on camera position
-void Anim4dcUpdateInstanceLOD(Anim4dcModelInstance *instances, int instanceCount, Vector3 cameraPosition);
+// Update LOD levels for all instances by the model's LOD policy, hiding instances outside the camera frustum
+// (an instance keeps its level until it is a hysteresis margin past the band limit, see Anim4dcSetLodHysteresis)
+void Anim4dcUpdateInstanceLOD(Anim4dcBakedModel *baked, Anim4dcModelInstance *instances, int instanceCount, Camera3D camera);
+
+// Update LOD levels of structure-of-arrays instances in one vectorizable pass (same results as Anim4dcUpdateInstanceLOD)
+void Anim4dcUpdateInstanceArraysLOD(Anim4dcBakedModel *baked, Anim4dcInstanceArrays *arrays, Camera3D camera);
+
+// Update LOD levels like Anim4dcUpdateInstanceLOD, but per spatial grid cell: cells inside one LOD band and
+// fully inside (or outside) the frustum are classified at once, only cells straddling an edge test each instance
+void Anim4dcUpdateInstanceLODGrid(Anim4dcBakedModel *baked, Anim4dcSpatialGrid *grid, Anim4dcModelInstance *instances, Camera3D camera);
+
+// Advance every instance's own animation clock (scaled by its LOD speed) and refresh its pose at its LOD interval
+void Anim4dcUpdateInstances(Anim4dcBakedModel *baked, Anim4dcModelInstance *instances, int instanceCount, float deltaTime);
+
+// Crossfade an instance from its animation to another over fadeDuration seconds (0 = switch at once),
+// the new animation starts at time 0 and fading instances interpolate on their own instead of sharing poses
+bool Anim4dcCrossfadeInstance(const Anim4dcBakedModel *baked, Anim4dcModelInstance *instance, int animationIndex, float fadeDuration);
+
+// Interpolate an instance's current pose into output (vertexCount * 3 floats, fewer for a mesh variant)
+bool Anim4dcInterpolateInstance(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance, float *output);
+
+// Get the shared pose computed for an instance this frame (NULL if it has none)
+float *Anim4dcGetInstancePose(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance);
+
+// Set the pose cache time step, instances within one step of each other share a pose (0 = no sharing)
+void Anim4dcSetPoseQuantum(Anim4dcBakedModel *baked, float seconds);
+
+// Get the default LOD policy (ANIM4DC_LOD_*_DIST2 limits, ANIM4DC_LOD_*_HYSTERESIS margins)
+Anim4dcLodPolicy Anim4dcGetDefaultLodPolicy(void);
+
+// Get a screen size LOD policy for a render target height (ANIM4DC_LOD_*_PIXELS limits, 0 = GetScreenHeight())
+Anim4dcLodPolicy Anim4dcGetScreenSizeLodPolicy(int viewportHeight);
+
+// Set the LOD policy of every baked model without one of its own (false if the limits are out of order)
+bool Anim4dcSetLodPolicy(Anim4dcLodPolicy policy);
+
+// Get the global LOD policy
+Anim4dcLodPolicy Anim4dcGetLodPolicy(void);
+
+// Give a baked model its own LOD policy (NULL = follow the global one again, false if the limits are out of order)
+bool Anim4dcSetModelLodPolicy(Anim4dcBakedModel *baked, const Anim4dcLodPolicy *policy);
+
+// Set the hysteresis margins around the NEAR/MID, MID/FAR, FAR/FROZEN and FROZEN/CULLED limits in the policy's unit
+// (0 = switch right at the limit), a model following the global policy gets its own copy of it
+void Anim4dcSetLodHysteresis(Anim4dcBakedModel *baked, float nearMargin, float midMargin, float farMargin, float cullMargin);
+
+// Render multiple model instances with LOD optimization (one upload per distinct pose)
+void Anim4dcRenderInstances(Anim4dcBakedModel *baked, Model model, Anim4dcModelInstance *instances, int instanceCount);
+
+// Replace a mesh's vertex positions and refresh only the position buffer on the GPU
+void Anim4dcUploadMeshPositions(Mesh *mesh, const float *positions);
+
+// Upload a full pose (all baked meshes, e.g. Anim4dcGetInstancePose()) into a model's meshes
+void Anim4dcUploadModelPositions(Anim4dcBakedModel *baked, Model *model, const float *positions);
+
+// Write an instance's pose into a model's meshes and upload them (shared pose or interpolated in place),
+// instances showing a mesh variant write into the variant's model instead (see Anim4dcGetInstanceModel)
+bool Anim4dcApplyInstancePose(Anim4dcBakedModel *baked, Model *model, const Anim4dcModelInstance *instance);
+
+// Get performance statistics of a baked model
+Anim4dcStats Anim4dcGetStats(const Anim4dcBakedModel *baked);
+
+//------------------------------------------------------------------------------------
+// Mesh Variant Functions
+//------------------------------------------------------------------------------------
+
+// Build and upload a render model for each decimated mesh variant, sharing the materials and static meshes of
+// the model the bake came from; from then on Anim4dcUpdateInstances switches instances' meshes with their LOD level
+bool Anim4dcLoadMeshVariants(Anim4dcBakedModel *baked, Model model);
+
+// Free the mesh variant render models, instances go back to the full resolution meshes
+void Anim4dcUnloadMeshVariants(Anim4dcBakedModel *baked);
+
+// Get the model to draw an instance with after Anim4dcApplyInstancePose (its mesh variant's, or model)
+Model Anim4dcGetInstanceModel(const Anim4dcBakedModel *baked, Model model, const Anim4dcModelInstance *instance);
+
+// Get the vertices per pose of the mesh baked for a LOD level (the full vertex count if it has no variant)
+int Anim4dcGetLodVertexCount(const Anim4dcBakedModel *baked, Anim4dcLodLevel level);
+
+//------------------------------------------------------------------------------------
+// Instance Arrays Functions
+//------------------------------------------------------------------------------------
+
+// Allocate structure-of-arrays storage for up to capacity instances, count starts at 0 (capacity 0 on failure)
+Anim4dcInstanceArrays Anim4dcCreateInstanceArrays(int capacity);
+
+// Free structure-of-arrays storage
+void Anim4dcUnloadInstanceArrays(Anim4dcInstanceArrays arrays);
+
+// Copy positions, scale and LOD level of an Anim4dcModelInstance array in (false if count exceeds the capacity)
+bool Anim4dcLoadInstanceArraysFrom(Anim4dcInstanceArrays *arrays, const Anim4dcModelInstance *instances, int count);
+
+// Copy LOD level, visibility and distance out to an Anim4dcModelInstance array for animation and rendering
+void Anim4dcCopyInstanceArraysLOD(const Anim4dcInstanceArrays *arrays, Anim4dcModelInstance *instances);
+
+//------------------------------------------------------------------------------------
+// Spatial Grid Functions
+//------------------------------------------------------------------------------------
+
+// Create a spatial grid for up to maxInstances instances (cellSize <= 0 = ANIM4DC_GRID_CELL_SIZE, NULL on failure)
+Anim4dcSpatialGrid *Anim4dcCreateSpatialGrid(float cellSize, int maxInstances);
+
+// Free a spatial grid
+void Anim4dcUnloadSpatialGrid(Anim4dcSpatialGrid *grid);
+
+// Insert every instance of an array, replacing the grid's previous contents (false if instanceCount exceeds the grid)
+bool Anim4dcBuildSpatialGrid(Anim4dcSpatialGrid *grid, const Anim4dcModelInstance *instances, int instanceCount);
+
+// Move one instance to the cell of its current position, call after changing its position or scale
+// (index == the number of instances inserted appends one)
+bool Anim4dcMoveGridInstance(Anim4dcSpatialGrid *grid, const Anim4dcModelInstance *instances, int index);
+
+// Get the number of occupied grid cells
+int Anim4dcGetSpatialGridCellCount(const Anim4dcSpatialGrid *grid);
+
+//------------------------------------------------------------------------------------
+// Interpolation Kernel Functions
+//------------------------------------------------------------------------------------
+
+// Check if a kernel is compiled in and supported by this CPU
+bool Anim4dcIsKernelSupported(Anim4dcKernel kernel);
 
-// Render multiple model instances with LOD optimization
-void Anim4dcRenderInstances(Model model, Anim4dcModelInstance *instances, int instanceCount);
+// Select the vertex interpolation kernel (false if unsupported)
+bool Anim4dcSetKernel(Anim4dcKernel kernel);
 
-// Get performance statistics
-Anim4dcStats Anim4dcGetStats(void);
+// Get the vertex interpolation kernel in use
+Anim4dcKernel Anim4dcGetKernel(void);
+
+// Get a kernel's name
+const char *Anim4dcGetKernelName(Anim4dcKernel kernel);
+
+// Check every supported kernel against the scalar reference (false if any deviates)
+bool Anim4dcValidateKernels(void);
 
 //------------------------------------------------------------------------------------
 // Utility Functions
@@ -200,8 +566,11 @@ Anim4dcStats Anim4dcGetStats(void);
 // Load model with fallback format support (GLTF -> IQM -> OBJ)
 Model Anim4dcLoadModel(const char *basePath);
 
-// Calculate memory usage of the animation system
-int Anim4dcCalculateMemoryUsage(void);
+// Calculate memory usage of one baked model in KB
+int Anim4dcCalculateMemoryUsage(const Anim4dcBakedModel *baked);
+
+// Calculate memory usage of every live baked model in KB
+int Anim4dcGetTotalMemoryUsage(void);
 
 // Get version information
 const char *Anim4dcGetVersion(void);
@@ -218,371 +587,5511 @@ const char *Anim4dcGetVersion(void);
 
 #ifdef ANIM4DC_IMPLEMENTATION
 
-#include <kos.h>
+#include <float.h>                  // FLT_MAX, DBL_MAX
+
+#if defined(_arch_dreamcast)
+    #include <kos.h>
+#endif
+
+// x86 kernels are built with per-function target attributes and picked at runtime
+#if !defined(ANIM4DC_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define ANIM4DC_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+    #define ANIM4DC_PREFETCH(address) __builtin_prefetch(address)
+    #define ANIM4DC_RESTRICT __restrict__
+#else
+    #define ANIM4DC_PREFETCH(address)
+    #define ANIM4DC_RESTRICT
+#endif
+
+//----------------------------------------------------------------------------------
+// Baked File Layout (.a4d, little-endian, offsets from start of file)
+//----------------------------------------------------------------------------------
+// [header][mesh table][animation table][keyframe table][variant table][variant keyframe tables][pad]
+// [keyframe vertex blocks][rest pose][moving vertex lists][per basis animation: shapes, coefficients]
+// [per rigid animation: segment starts and vertices, transforms]
+// [per variant: keyframe vertex blocks, source vertices, indices], each ANIM4DC_BAKED_ALIGNMENT aligned
+// Each keyframe block holds the baked meshes back to back as laid out by the mesh table (or the variant's mesh counts),
+// keyframes of a sparse animation hold deltas from the rest pose for its moving vertices only and those of a
+// basis compressed animation have empty blocks. Rigid animations are sparse, their segment vertices are
+// neither moving nor static but the rest pose through one 3x4 transform per segment and keyframe
+
+typedef struct Anim4dcBakedHeader {
+    char magic[4];              // ANIM4DC_BAKED_MAGIC
+    uint32_t version;           // ANIM4DC_BAKED_VERSION
+    uint32_t animationCount;    // Entries in the animation table
+    uint32_t keyframeCount;     // Entries in the keyframe table (all animations)
+    uint32_t vertexCount;       // Vertices per keyframe
+    uint32_t storage;           // Anim4dcStorageMode of the vertex blocks
+    uint32_t meshCount;         // Entries in the mesh table
+    uint32_t meshOffset;        // Offset of the mesh table
+    uint32_t animationOffset;   // Offset of the animation table
+    uint32_t keyframeOffset;    // Offset of the keyframe table
+    uint32_t variantCount;      // Entries in the variant table
+    uint32_t variantOffset;     // Offset of the variant table
+    uint32_t restOffset;        // Offset of the rest pose, float positions of every vertex (0 = no sparse animation)
+    uint32_t fileSize;          // Total file size in bytes
+} Anim4dcBakedHeader;
+
+typedef struct Anim4dcBakedMesh {
+    uint32_t meshIndex;         // Index into model.meshes
+    uint32_t vertexOffset;      // First vertex of this mesh in each keyframe
+    uint32_t vertexCount;       // Vertices of this mesh
+    uint32_t sourceVertexCount; // Vertices of the mesh before welding (= vertexCount if not welded)
+} Anim4dcBakedMesh;
+
+typedef struct Anim4dcBakedAnimation {
+    char name[ANIM4DC_MAX_NAME_LENGTH]; // Animation name
+    float duration;             // Total animation duration
+    uint32_t keyframeCount;     // Keyframes in this animation
+    uint32_t firstKeyframe;     // Index of the first keyframe in the keyframe table
+    uint32_t looping;           // Should animation loop?
+    uint32_t movingCount;       // Vertices stored per keyframe of a sparse animation
+    uint32_t movingOffset;      // Offset of its moving vertex list (uint32, ascending; 0 = dense absolute keyframes)
+    uint32_t basisCount;        // Basis shapes of a basis compressed animation
+    uint32_t basisOffset;       // Offset of its float mean and basis shapes (0 = keyframe vertex blocks)
+    uint32_t coefficientOffset; // Offset of its float shape weights, basisCount per keyframe
+    uint32_t segmentCount;      // Rigid segments of a rigid animation
+    uint32_t segmentOffset;     // Offset of its uint32 segment starts (segmentCount + 1) then segment vertices (0 = none)
+    uint32_t transformOffset;   // Offset of its float 3x4 segment transforms, segmentCount per keyframe
+} Anim4dcBakedAnimation;
+
+typedef struct Anim4dcBakedKeyframe {
+    float timestamp;            // Time for this keyframe in seconds
+    uint32_t vertexOffset;      // Offset of this keyframe's vertex block
+    float offset[3];            // Dequantization offset (INT16 storage)
+    float scale[3];             // Dequantization scale (INT16 storage)
+} Anim4dcBakedKeyframe;
+
+typedef struct Anim4dcBakedVariant {
+    uint32_t lodLevel;          // Anim4dcLodLevel the mesh was decimated for (ascending, MID to FROZEN)
+    uint32_t vertexCount;       // Vertices per variant keyframe
+    uint32_t meshVertexCounts[ANIM4DC_MAX_MESHES]; // Vertices of each mesh table entry, back to back
+    uint32_t meshIndexCounts[ANIM4DC_MAX_MESHES];  // Triangle indices of each mesh table entry, back to back
+    uint32_t keyframeOffset;    // Offset of this variant's keyframe table (header keyframeCount entries)
+    uint32_t sourceOffset;      // Offset of the source vertices (uint32 full keyframe vertex per variant vertex)
+    uint32_t indexOffset;       // Offset of the indices (uint16, relative to each mesh's first vertex)
+} Anim4dcBakedVariant;
+
+//----------------------------------------------------------------------------------
+// Internal Types
+//----------------------------------------------------------------------------------
+
+// Decimated copy of the baked meshes drawn from one LOD level on, with its own keyframes and indices
+typedef struct Anim4dcMeshVariant {
+    int vertexCount;            // Vertices per variant keyframe, all baked meshes (0 = no variant for the level)
+    Anim4dcMeshRange meshes[ANIM4DC_MAX_MESHES]; // Block of each baked mesh, in the order of the full resolution ones
+    int indexCounts[ANIM4DC_MAX_MESHES];         // Triangle indices of each mesh, back to back in indices
+    int indexCount;             // Indices of all meshes
+    uint32_t *sourceVertices;   // Full resolution keyframe vertex each variant vertex copies
+    unsigned short *indices;    // Triangle lists, relative to each mesh's first vertex
+    Anim4dcVertexKeyframe *keyframes; // Every animation's keyframes in order, timestamps match the full resolution ones
+    Model model;                // Render model (meshCount 0 = not loaded, see Anim4dcLoadMeshVariants)
+} Anim4dcMeshVariant;
+
+// Baked model state behind an Anim4dcBakedModel handle
+struct Anim4dcBakedModel {
+    Anim4dcVertexAnimation *animations;                         // Baked animations (inside the arena)
+    int animationCount;                                         // Number of animations
+    int currentAnimation;                                       // Current animation index
+    float currentTime;                                         // Current playback time
+    int currentKeyframe;                                       // Keyframe cursor of the global playback
+    int fadeAnimation;                                         // Animation fading out of the global playback (-1 = none)
+    float fadeTime;                                            // Playback time of the animation fading out
+    int fadeKeyframe;                                          // Keyframe cursor of the animation fading out
+    float fadeElapsed;                                         // Time since the crossfade started
+    float fadeDuration;                                        // Crossfade length in seconds
+    bool paused;                                               // Global playback clocks frozen, see Anim4dcSetAnimationPaused
+    float *interpolationBuffer;                                // Internal buffer for interpolated vertices (NULL while a destination is registered)
+    float *outputVertices;                                    // Where Anim4dcUpdateAnimation writes positions
+    int outputStride;                                         // Bytes between consecutive output positions
+    int vertexCount;                                          // Number of vertices per keyframe (all baked meshes)
+    Anim4dcMeshRange meshes[ANIM4DC_MAX_MESHES];              // Baked skinned meshes, static ones are skipped
+    int meshCount;                                            // Number of baked meshes
+    Mesh *outputMeshes;                                       // Model meshes Anim4dcUpdateAnimation writes into (NULL = outputVertices)
+    Anim4dcMeshVariant variants[ANIM4DC_MAX_MESH_VARIANTS];   // Decimated meshes by the LOD level they were baked for ([0] unused)
+    Anim4dcStorageMode storage;                               // Keyframe vertex storage
+    float *restPose;                                          // Bind pose sparse animations store deltas from (NULL = none)
+    Vector3 boundsCenter;                                     // Bounding sphere of every keyframe (model space)
+    float boundsRadius;
+    Anim4dcLodPolicy lodPolicy;                               // Own LOD policy, used when hasLodPolicy is set
+    bool hasLodPolicy;                                        // false = follow the global LOD policy
+    float lodInnerLimits[4];                                  // Squared distances an instance past a limit must come back within
+    float lodOuterLimits[4];                                  // Squared distances an instance before a limit must pass (both for scale 1)
+    float lodDistanceWeight;                                  // LOD metric = squared distance * weight + offset
+    float lodDistanceOffset;
+    float lodScaleWeight;                                     // 1 = limits grow with the squared instance scale
+    Anim4dcPoseCacheEntry poseCache[ANIM4DC_POSE_CACHE_SIZE]; // Poses shared by instances
+    float *poseCacheVertices;                                 // Backing storage for all cached poses
+    float poseQuantum;                                        // Pose cache time step (0 = no sharing)
+    unsigned int poseFrame;                                   // Counts Anim4dcUpdateInstances calls
+    void *arena;                                              // One block for animations, keyframes and vertex blocks (NULL while baking)
+    int arenaSize;                                            // Bytes allocated for the arena
+    Anim4dcStats stats;                                       // Statistics of this model's instances
+    Anim4dcBakedModel *next;                                  // Next live baked model
+};
+
+// One cell of a spatial grid, its instances are chained through the grid's next/previous arrays
+typedef struct Anim4dcGridCell {
+    int x, y, z;                // Cell coordinates (position / cell size, rounded down)
+    Vector3 boundsMin;          // Box around the positions inserted since the cell was last empty
+    Vector3 boundsMax;
+    int first;                  // First instance in the cell (-1 = empty)
+    int count;                  // Instances in the cell
+    int state;                  // Classification written to every instance last update (-1 = visit them)
+    int inserted;               // Instances linked at the head of the chain since the last update
+} Anim4dcGridCell;
+
+// Spatial grid behind an Anim4dcSpatialGrid handle, an open addressing hash of cell coordinates
+struct Anim4dcSpatialGrid {
+    float cellSize;             // Cell edge length
+    int *table;                 // Open addressing hash of cell coordinates to cell index (-1 = free slot)
+    int tableSize;              // Hash table size (power of two)
+    Anim4dcGridCell *cells;     // Cells in claim order, walked sequentially (empty ones stay until a rebuild)
+    int cellCount;              // Cells claimed, empty or not
+    int occupiedCells;          // Cells holding at least one instance
+    int *instanceCell;          // Cell index of each instance (-1 = not inserted)
+    int *next;                  // Next instance in the same cell (-1 = last)
+    int *previous;              // Previous instance in the same cell (-1 = first)
+    int instanceCount;          // Instances inserted (indices below this)
+    int maxInstances;           // Capacity of the instance arrays
+    float maxScale;             // Largest instance scale inserted, pads cell bounds for frustum tests
+    float minScale;             // Smallest instance scale inserted, bounds screen size LOD limits
+    const Anim4dcBakedModel *baked; // Model the cell states were classified for
+};
+
+// Library state
+typedef struct Anim4dcSystem {
+    Anim4dcBakedModel *models;  // Live baked models, freed by Anim4dcShutdown() if still loaded
+    Anim4dcKernel kernel;       // Vertex interpolation kernel in use
+    Anim4dcLodPolicy lodPolicy; // LOD policy of models without their own
+    bool initialized;           // System initialization state
+} Anim4dcSystem;
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
-static Anim4dcAnimationSystem anim4dc = { 0 };
-static Anim4dcStats anim4dc_stats = { 0 };
+static Anim4dcSystem anim4dc = { 0 };
 
 //----------------------------------------------------------------------------------
 // Internal Helper Functions
 //----------------------------------------------------------------------------------
 
-// Interpolate between two vertex buffers
-static void Anim4dcInterpolateVertices(float *output, float *vertices1, float *vertices2, float t, int vertexCount) {
-    for (int i = 0; i < vertexCount * 3; i++) {
-        output[i] = vertices1[i] + (vertices2[i] - vertices1[i]) * t;
+//----------------------------------------------------------------------------------
+// Interpolation Kernels
+//----------------------------------------------------------------------------------
+// Every kernel computes v1 + (v2 - v1) * t, output positions are stride bytes apart and output
+// may be vertices1 itself. Vector kernels take packed output, strided output runs the scalar loop
+
+typedef void (*Anim4dcLerpKernel)(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount);
+
+// Reference kernel, the others are validated against it
+static void Anim4dcLerpScalar(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount) {
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        output[0] = vertices1[i] + (vertices2[i] - vertices1[i]) * t;
+        output[1] = vertices1[i + 1] + (vertices2[i + 1] - vertices1[i + 1]) * t;
+        output[2] = vertices1[i + 2] + (vertices2[i + 2] - vertices1[i + 2]) * t;
+        output = (float*)((char*)output + stride);
     }
 }
 
-// Capture a vertex keyframe from current skeletal animation state  
-static void Anim4dcCaptureVertexKeyframe(Anim4dcVertexAnimation *animation, float timestamp, float *vertexData, int vertexCount) {
-    if (animation->keyframeCount >= ANIM4DC_MAX_KEYFRAMES) return;
-    
-    Anim4dcVertexKeyframe *keyframe = &animation->keyframes[animation->keyframeCount];
+// Plain C 4x unroll: four independent lerps per step give the compiler room to overlap FPU latency,
+// both sources are prefetched a cache line ahead
+static void Anim4dcLerpUnrolled4(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount) {
+    if (stride != 3 * sizeof(float)) {
+        Anim4dcLerpScalar(output, stride, vertices1, vertices2, t, vertexCount);
+        return;
+    }
     
-    // Allocate memory for vertex data
-    int vertexDataSize = vertexCount * 3 * sizeof(float);
-    keyframe->vertices = (float*)malloc(vertexDataSize);
+    int count = vertexCount * 3;
+    int i = 0;
     
-    if (keyframe->vertices) {
-        memcpy(keyframe->vertices, vertexData, vertexDataSize);
-        keyframe->vertexCount = vertexCount;
-        keyframe->timestamp = timestamp;
-        animation->keyframeCount++;
+    for (; i + 4 <= count; i += 4) {
+        if ((i & 7) == 0) {
+            ANIM4DC_PREFETCH(vertices1 + i + 8);
+            ANIM4DC_PREFETCH(vertices2 + i + 8);
+        }
+        
+        float a0 = vertices1[i], a1 = vertices1[i + 1], a2 = vertices1[i + 2], a3 = vertices1[i + 3];
+        float b0 = vertices2[i], b1 = vertices2[i + 1], b2 = vertices2[i + 2], b3 = vertices2[i + 3];
+        output[i] = a0 + (b0 - a0) * t;
+        output[i + 1] = a1 + (b1 - a1) * t;
+        output[i + 2] = a2 + (b2 - a2) * t;
+        output[i + 3] = a3 + (b3 - a3) * t;
     }
-}
-
-//----------------------------------------------------------------------------------
-// Animation System Core Functions Implementation
-//----------------------------------------------------------------------------------
-
-bool Anim4dcInit(void) {
-    memset(&anim4dc, 0, sizeof(Anim4dcAnimationSystem));
-    memset(&anim4dc_stats, 0, sizeof(Anim4dcStats));
-    
-    anim4dc.currentAnimation = -1;
-    anim4dc.initialized = true;
     
-    printf("Anim4DC v%s initialized\n", ANIM4DC_VERSION);
-    return true;
+    for (; i < count; i++) output[i] = vertices1[i] + (vertices2[i] - vertices1[i]) * t;
 }
 
-void Anim4dcShutdown(void) {
-    if (!anim4dc.initialized) return;
-    
-    // Free all keyframe vertex data
-    for (int a = 0; a < anim4dc.animationCount; a++) {
-        for (int k = 0; k < anim4dc.animations[a].keyframeCount; k++) {
-            if (anim4dc.animations[a].keyframes[k].vertices) {
-                free(anim4dc.animations[a].keyframes[k].vertices);
-                anim4dc.animations[a].keyframes[k].vertices = NULL;
-            }
-        }
+#if defined(ANIM4DC_X86_KERNELS)
+__attribute__((target("sse")))
+static void Anim4dcLerpSSE(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount) {
+    if (stride != 3 * sizeof(float)) {
+        Anim4dcLerpScalar(output, stride, vertices1, vertices2, t, vertexCount);
+        return;
     }
     
-    // Free interpolation buffer
-    if (anim4dc.interpolationBuffer) {
-        free(anim4dc.interpolationBuffer);
-        anim4dc.interpolationBuffer = NULL;
+    int count = vertexCount * 3;
+    int i = 0;
+    __m128 factor = _mm_set1_ps(t);
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(vertices1 + i);
+        __m128 b = _mm_loadu_ps(vertices2 + i);
+        _mm_storeu_ps(output + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), factor)));
     }
     
-    memset(&anim4dc, 0, sizeof(Anim4dcAnimationSystem));
-    printf("Anim4DC shutdown complete\n");
+    for (; i < count; i++) output[i] = vertices1[i] + (vertices2[i] - vertices1[i]) * t;
 }
 
-bool Anim4dcCheckModelCompatibility(Model model, ModelAnimation *animations, int animationCount) {
-    if (model.meshCount <= 0) {
-        printf("Anim4DC: ERROR - No meshes in model\n");
-        return false;
+__attribute__((target("avx")))
+static void Anim4dcLerpAVX(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount) {
+    if (stride != 3 * sizeof(float)) {
+        Anim4dcLerpScalar(output, stride, vertices1, vertices2, t, vertexCount);
+        return;
     }
     
-    if (animationCount <= 0) {
-        printf("Anim4DC: Model loaded as static (no animations)\n");
-        return false;
-    }
+    int count = vertexCount * 3;
+    int i = 0;
+    __m256 factor = _mm256_set1_ps(t);
     
-    if (model.boneCount <= 0) {
-        printf("Anim4DC: ERROR - Model has no bones\n");
-        return false;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(vertices1 + i);
+        __m256 b = _mm256_loadu_ps(vertices2 + i);
+        _mm256_storeu_ps(output + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), factor)));
     }
     
-    if (model.bones == NULL || model.bindPose == NULL) {
-        printf("Anim4DC: ERROR - Model missing bone hierarchy\n");
-        return false;
-    }
+    for (; i < count; i++) output[i] = vertices1[i] + (vertices2[i] - vertices1[i]) * t;
+}
+#endif
+
+// Kernels by Anim4dcKernel, NULL when not compiled in
+static const Anim4dcLerpKernel anim4dcKernels[ANIM4DC_KERNEL_COUNT] = {
+    Anim4dcLerpScalar,
+    Anim4dcLerpUnrolled4,
+#if defined(ANIM4DC_X86_KERNELS)
+    Anim4dcLerpSSE,
+    Anim4dcLerpAVX
+#else
+    NULL,
+    NULL
+#endif
+};
+
+static const char *anim4dcKernelNames[ANIM4DC_KERNEL_COUNT] = { "scalar", "unrolled4", "sse", "avx" };
+
+// Interpolate between two vertex buffers with the selected kernel
+static void Anim4dcInterpolateVertices(float *output, int stride, const float *vertices1, const float *vertices2, float t, int vertexCount) {
+    anim4dcKernels[anim4dc.kernel](output, stride, vertices1, vertices2, t, vertexCount);
+}
+
+// Dequantize and interpolate two INT16 keyframes in one pass
+// (o1 + q1*s1)*(1 - t) + (o2 + q2*s2)*t folds into base + q1*scale1 + q2*scale2
+static void Anim4dcInterpolateQuantized(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex, int vertexCount) {
+    float base[3] = {
+        keyframe1->offset.x + (keyframe2->offset.x - keyframe1->offset.x) * t,
+        keyframe1->offset.y + (keyframe2->offset.y - keyframe1->offset.y) * t,
+        keyframe1->offset.z + (keyframe2->offset.z - keyframe1->offset.z) * t
+    };
+    float scale1[3] = { keyframe1->scale.x * (1.0f - t), keyframe1->scale.y * (1.0f - t), keyframe1->scale.z * (1.0f - t) };
+    float scale2[3] = { keyframe2->scale.x * t, keyframe2->scale.y * t, keyframe2->scale.z * t };
+    const short *q1 = keyframe1->quantized + firstVertex * 3;
+    const short *q2 = keyframe2->quantized + firstVertex * 3;
     
-    // Check first animation
-    ModelAnimation anim = animations[0];
-    if (anim.boneCount != model.boneCount) {
-        printf("Anim4DC: ERROR - Bone count mismatch! Model:%d != Anim:%d\n", 
-               model.boneCount, anim.boneCount);
-        return false;
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        output[0] = base[0] + q1[i] * scale1[0] + q2[i] * scale2[0];
+        output[1] = base[1] + q1[i + 1] * scale1[1] + q2[i + 1] * scale2[1];
+        output[2] = base[2] + q1[i + 2] * scale1[2] + q2[i + 2] * scale2[2];
+        output = (float*)((char*)output + stride);
+    }
+}
+
+// Crossfade two keyframe pairs in one pass over memory: each pair is interpolated and the two
+// results blended by weight (0 = first pair, 1 = second) without intermediate buffers
+static void Anim4dcBlendVertices(float *output, int stride, const float *vertices1, const float *vertices2, float t1, 
+                                 const float *vertices3, const float *vertices4, float t2, float weight, int vertexCount) {
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        for (int c = 0; c < 3; c++) {
+            float from = vertices1[i + c] + (vertices2[i + c] - vertices1[i + c]) * t1;
+            float to = vertices3[i + c] + (vertices4[i + c] - vertices3[i + c]) * t2;
+            output[c] = from + (to - from) * weight;
+        }
+        output = (float*)((char*)output + stride);
     }
+}
+
+// Crossfade two INT16 keyframe pairs, every dequantization and blend factor folds into one
+// scale per source so each output is base + four multiply-adds
+static void Anim4dcBlendQuantized(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t1, 
+                                  const Anim4dcVertexKeyframe *keyframe3, const Anim4dcVertexKeyframe *keyframe4, float t2, float weight, 
+                                  int firstVertex, int vertexCount) {
+    const Anim4dcVertexKeyframe *keyframes[4] = { keyframe1, keyframe2, keyframe3, keyframe4 };
+    float factors[4] = { (1.0f - t1) * (1.0f - weight), t1 * (1.0f - weight), (1.0f - t2) * weight, t2 * weight };
+    float base[3] = { 0.0f, 0.0f, 0.0f };
+    float scales[4][3];
+    const short *q[4];
     
-    if (anim.bones == NULL || anim.framePoses == NULL) {
-        printf("Anim4DC: ERROR - Animation missing data\n");
-        return false;
+    for (int k = 0; k < 4; k++) {
+        base[0] += keyframes[k]->offset.x * factors[k];
+        base[1] += keyframes[k]->offset.y * factors[k];
+        base[2] += keyframes[k]->offset.z * factors[k];
+        scales[k][0] = keyframes[k]->scale.x * factors[k];
+        scales[k][1] = keyframes[k]->scale.y * factors[k];
+        scales[k][2] = keyframes[k]->scale.z * factors[k];
+        q[k] = keyframes[k]->quantized + firstVertex * 3;
     }
     
-    // Check for skinning data
-    bool hasSkinning = false;
-    for (int i = 0; i < model.meshCount; i++) {
-        Mesh mesh = model.meshes[i];
-        if (mesh.boneIds && mesh.boneWeights && mesh.animVertices) {
-            hasSkinning = true;
-            break;
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        for (int c = 0; c < 3; c++) {
+            output[c] = base[c] + q[0][i + c] * scales[0][c] + q[1][i + c] * scales[1][c] + 
+                        q[2][i + c] * scales[2][c] + q[3][i + c] * scales[3][c];
         }
+        output = (float*)((char*)output + stride);
     }
+}
+
+// Keyframe pair set up to decode one stored position at a time (sparse or basis keyframes and mixed crossfades)
+typedef struct Anim4dcPairSampler {
+    const Anim4dcVertexKeyframe *keyframe1;
+    const Anim4dcVertexKeyframe *keyframe2;
+    float t;                    // Interpolation factor
+    float base[3];              // INT16: interpolated dequantization offset
+    float scale1[3];            // INT16: dequantization scales weighted by 1 - t and t
+    float scale2[3];
+    float weights[ANIM4DC_MAX_BASIS_SHAPES]; // Basis: interpolated shape weights
+    int cursor;                 // Next moving list entry of a sparse pair
+} Anim4dcPairSampler;
+
+// First entry of an ascending moving vertex list not below vertex
+static int Anim4dcFindMovingVertex(const uint32_t *moving, int count, int vertex) {
+    int low = 0;
+    int high = count;
     
-    if (!hasSkinning) {
-        printf("Anim4DC: ERROR - Model missing skinning data\n");
-        return false;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if ((int)moving[middle] < vertex) low = middle + 1;
+        else high = middle;
     }
     
-    printf("Anim4DC: Model compatibility check passed\n");
-    return true;
+    return low;
 }
 
-bool Anim4dcBakeVertexAnimations(Model model, ModelAnimation *animations, int animationCount) {
-    if (!anim4dc.initialized) {
-        printf("Anim4DC: ERROR - System not initialized\n");
-        return false;
-    }
+// Set up a pair for sampling vertices in ascending order from firstVertex on
+static void Anim4dcPreparePair(Anim4dcPairSampler *sampler, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex) {
+    sampler->keyframe1 = keyframe1;
+    sampler->keyframe2 = keyframe2;
+    sampler->t = t;
     
-    if (!Anim4dcCheckModelCompatibility(model, animations, animationCount)) {
-        return false;
+    const float offset1[3] = { keyframe1->offset.x, keyframe1->offset.y, keyframe1->offset.z };
+    const float offset2[3] = { keyframe2->offset.x, keyframe2->offset.y, keyframe2->offset.z };
+    const float scale1[3] = { keyframe1->scale.x, keyframe1->scale.y, keyframe1->scale.z };
+    const float scale2[3] = { keyframe2->scale.x, keyframe2->scale.y, keyframe2->scale.z };
+    for (int c = 0; c < 3; c++) {
+        sampler->base[c] = offset1[c] + (offset2[c] - offset1[c]) * t;
+        sampler->scale1[c] = scale1[c] * (1.0f - t);
+        sampler->scale2[c] = scale2[c] * t;
     }
     
-    // Default animation names
-    const char* animNames[] = {"Survey", "Walk", "Run", "Jump", "Idle", "Attack", "Death", "Custom"};
-    int animsToBake = (animationCount > ANIM4DC_MAX_ANIMATIONS) ? ANIM4DC_MAX_ANIMATIONS : animationCount;
+    // Keyframes are linear in their weights, so interpolating those first interpolates the positions
+    for (int k = 0; k < keyframe1->basisCount; k++) {
+        sampler->weights[k] = keyframe1->coefficients[k] + (keyframe2->coefficients[k] - keyframe1->coefficients[k]) * t;
+    }
     
-    anim4dc.animationCount = animsToBake;
-    anim4dc.vertexCount = model.meshes[0].vertexCount;
+    sampler->cursor = keyframe1->moving ? Anim4dcFindMovingVertex(keyframe1->moving, keyframe1->vertexCount, firstVertex) : 0;
+}
+
+// Interpolate the pair's stored position (or delta) at index
+static void Anim4dcSampleStored(const Anim4dcPairSampler *sampler, int index, float *output) {
+    const Anim4dcVertexKeyframe *keyframe = sampler->keyframe1;
     
-    for (int a = 0; a < animsToBake; a++) {
-        ModelAnimation skelAnim = animations[a];
-        Anim4dcVertexAnimation *vertAnim = &anim4dc.animations[a];
-        
-        // Setup vertex animation
-        snprintf(vertAnim->name, ANIM4DC_MAX_NAME_LENGTH, "%s", 
-                 (a < 8) ? animNames[a] : "Unknown");
-        vertAnim->keyframeCount = 0;
-        vertAnim->duration = skelAnim.frameCount / 20.0f;  // Assume 20 FPS
-        vertAnim->looping = true;
-        
-        printf("Anim4DC: Baking animation %d: %s (%d frames)\n", 
-               a, vertAnim->name, skelAnim.frameCount);
-        
-        // Capture keyframes at regular intervals to save memory
-        int keyframeStep = (skelAnim.frameCount > 40) ? 8 : 4;
-        
-        for (int frame = 0; frame < skelAnim.frameCount; frame += keyframeStep) {
-            // Apply skeletal animation to get animated vertices
-            UpdateModelAnimation(model, skelAnim, frame);
-            
-            // Capture the animated vertex positions
-            if (model.meshes[0].animVertices) {
-                float timestamp = (frame / 20.0f);
-                Anim4dcCaptureVertexKeyframe(vertAnim, timestamp, model.meshes[0].animVertices, anim4dc.vertexCount);
-            }
+    if (keyframe->basis) {
+        const float *shape = keyframe->basis + index * 3;
+        int shapeSize = keyframe->vertexCount * 3;
+        output[0] = shape[0];
+        output[1] = shape[1];
+        output[2] = shape[2];
+        for (int k = 0; k < keyframe->basisCount; k++) {
+            shape += shapeSize;
+            output[0] += shape[0] * sampler->weights[k];
+            output[1] += shape[1] * sampler->weights[k];
+            output[2] += shape[2] * sampler->weights[k];
         }
-        
-        printf("Anim4DC: Baked %d keyframes for %s\n", vertAnim->keyframeCount, vertAnim->name);
-    }
-    
-    // Allocate interpolation buffer
-    anim4dc.interpolationBuffer = (float*)malloc(anim4dc.vertexCount * 3 * sizeof(float));
-    if (!anim4dc.interpolationBuffer) {
-        printf("Anim4DC: ERROR - Failed to allocate interpolation buffer\n");
-        return false;
+    } else if (keyframe->quantized) {
+        const short *q1 = sampler->keyframe1->quantized + index * 3;
+        const short *q2 = sampler->keyframe2->quantized + index * 3;
+        for (int c = 0; c < 3; c++) output[c] = sampler->base[c] + q1[c] * sampler->scale1[c] + q2[c] * sampler->scale2[c];
+    } else {
+        const float *v1 = sampler->keyframe1->vertices + index * 3;
+        const float *v2 = sampler->keyframe2->vertices + index * 3;
+        for (int c = 0; c < 3; c++) output[c] = v1[c] + (v2[c] - v1[c]) * sampler->t;
     }
-    
-    // Set default animation
-    anim4dc.currentAnimation = 0;
-    anim4dc.currentTime = 0.0f;
-    
-    // Calculate memory usage
-    anim4dc_stats.memoryUsageKB = Anim4dcCalculateMemoryUsage();
-    
-    printf("Anim4DC: Vertex animation baking complete! Using %d KB memory\n", 
-           anim4dc_stats.memoryUsageKB);
-    
-    return true;
 }
 
-void Anim4dcUpdateAnimation(float deltaTime) {
-    if (!anim4dc.initialized || anim4dc.currentAnimation < 0 || 
-        anim4dc.currentAnimation >= anim4dc.animationCount) {
+// Interpolate one vertex of the pair, sparse pairs must be sampled in ascending vertex order
+static void Anim4dcSamplePair(Anim4dcPairSampler *sampler, int vertex, float *output) {
+    const Anim4dcVertexKeyframe *keyframe = sampler->keyframe1;
+    if (!keyframe->moving) {
+        Anim4dcSampleStored(sampler, vertex, output);
         return;
     }
     
-    Anim4dcVertexAnimation *currentAnim = &anim4dc.animations[anim4dc.currentAnimation];
-    if (currentAnim->keyframeCount < 2 || !anim4dc.interpolationBuffer) return;
-    
-    // Update animation time
-    anim4dc.currentTime += deltaTime;
-    if (anim4dc.currentTime >= currentAnim->duration) {
-        anim4dc.currentTime = 0.0f;  // Loop
+    const float *rest = keyframe->rest + vertex * 3;
+    if (sampler->cursor < keyframe->vertexCount && (int)keyframe->moving[sampler->cursor] == vertex) {
+        Anim4dcSampleStored(sampler, sampler->cursor++, output);
+        for (int c = 0; c < 3; c++) output[c] += rest[c];
+    } else {
+        for (int c = 0; c < 3; c++) output[c] = rest[c];
     }
+}
+
+// Interpolate a sparse keyframe pair: runs of static vertices are copied from the rest pose, only the
+// moving ones are interpolated, as rest + delta
+static void Anim4dcInterpolateSparse(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex, int vertexCount) {
+    Anim4dcPairSampler sampler;
+    Anim4dcPreparePair(&sampler, keyframe1, keyframe2, t, firstVertex);
     
-    // Find current and next keyframes
-    int currentKeyframe = 0;
-    int nextKeyframe = 1;
+    const uint32_t *moving = keyframe1->moving;
+    const float *rest = keyframe1->rest;
+    int end = firstVertex + vertexCount;
+    int vertex = firstVertex;
     
-    for (int i = 0; i < currentAnim->keyframeCount - 1; i++) {
-        if (anim4dc.currentTime >= currentAnim->keyframes[i].timestamp && 
-            anim4dc.currentTime < currentAnim->keyframes[i + 1].timestamp) {
-            currentKeyframe = i;
-            nextKeyframe = i + 1;
-            break;
+    while (vertex < end) {
+        int next = (sampler.cursor < keyframe1->vertexCount && (int)moving[sampler.cursor] < end) ? (int)moving[sampler.cursor] : end;
+        
+        if (stride == 3 * sizeof(float)) {
+            memcpy(output, rest + vertex * 3, (next - vertex) * 3 * sizeof(float));
+            output += (next - vertex) * 3;
+            vertex = next;
+        } else {
+            for (; vertex < next; vertex++) {
+                memcpy(output, rest + vertex * 3, 3 * sizeof(float));
+                output = (float*)((char*)output + stride);
+            }
         }
+        if (vertex >= end) break;
+        
+        float delta[3];
+        Anim4dcSampleStored(&sampler, sampler.cursor++, delta);
+        output[0] = rest[vertex * 3] + delta[0];
+        output[1] = rest[vertex * 3 + 1] + delta[1];
+        output[2] = rest[vertex * 3 + 2] + delta[2];
+        output = (float*)((char*)output + stride);
+        vertex++;
     }
+}
+
+// Reconstruct vertices of a basis compressed keyframe pair: the mean shape plus each basis shape
+// weighted by the interpolated coefficients, K multiply-adds per coordinate
+static void Anim4dcInterpolateBasis(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex, int vertexCount) {
+    Anim4dcPairSampler sampler;
+    Anim4dcPreparePair(&sampler, keyframe1, keyframe2, t, firstVertex);
     
-    // Handle looping
-    if (anim4dc.currentTime >= currentAnim->keyframes[currentAnim->keyframeCount - 1].timestamp) {
-        currentKeyframe = currentAnim->keyframeCount - 1;
-        nextKeyframe = 0;
-    }
+    const float *mean = keyframe1->basis + firstVertex * 3;
+    int shapeSize = keyframe1->vertexCount * 3;
+    int basisCount = keyframe1->basisCount;
     
-    // Calculate interpolation factor
-    float t1 = currentAnim->keyframes[currentKeyframe].timestamp;
-    float t2 = (nextKeyframe == 0) ? currentAnim->duration : currentAnim->keyframes[nextKeyframe].timestamp;
-    float t = 0.0f;
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        float x = mean[i], y = mean[i + 1], z = mean[i + 2];
+        const float *shape = mean + i;
+        
+        for (int k = 0; k < basisCount; k++) {
+            shape += shapeSize;
+            x += shape[0] * sampler.weights[k];
+            y += shape[1] * sampler.weights[k];
+            z += shape[2] * sampler.weights[k];
+        }
+        
+        output[0] = x;
+        output[1] = y;
+        output[2] = z;
+        output = (float*)((char*)output + stride);
+    }
+}
+
+// Crossfade two keyframe pairs of which at least one is sparse or basis compressed, one vertex at a time
+static void Anim4dcBlendSampled(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t1, 
+                                const Anim4dcVertexKeyframe *keyframe3, const Anim4dcVertexKeyframe *keyframe4, float t2, float weight, 
+                                int firstVertex, int vertexCount) {
+    Anim4dcPairSampler from;
+    Anim4dcPairSampler to;
+    Anim4dcPreparePair(&from, keyframe1, keyframe2, t1, firstVertex);
+    Anim4dcPreparePair(&to, keyframe3, keyframe4, t2, firstVertex);
+    
+    for (int vertex = firstVertex; vertex < firstVertex + vertexCount; vertex++) {
+        float a[3], b[3];
+        Anim4dcSamplePair(&from, vertex, a);
+        Anim4dcSamplePair(&to, vertex, b);
+        
+        for (int c = 0; c < 3; c++) output[c] = a[c] + (b[c] - a[c]) * weight;
+        output = (float*)((char*)output + stride);
+    }
+}
+
+// Overwrite the rigid segment vertices of [firstVertex, firstVertex + vertexCount) with the rest pose through their
+// segment's interpolated transform, the sparse pass before left them at rest
+// NOTE: On Dreamcast each segment's transform is loaded into XMTRX once and FTRV moves its vertices
+// (GLdc loads its own matrices again for every draw)
+static void Anim4dcTransformSegments(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex, int vertexCount) {
+    int end = firstVertex + vertexCount;
+    
+    for (int s = 0; s < keyframe1->segmentCount; s++) {
+        const uint32_t *vertices = keyframe1->segmentVertices + keyframe1->segmentStarts[s];
+        int count = keyframe1->segmentStarts[s + 1] - keyframe1->segmentStarts[s];
+        int j = (firstVertex > 0) ? Anim4dcFindMovingVertex(vertices, count, firstVertex) : 0;
+        if (j >= count || (int)vertices[j] >= end) continue;
+        
+        // Transformed positions are linear in the transform, so interpolating it interpolates them
+        const float *m1 = keyframe1->transforms + s * 12;
+        const float *m2 = keyframe2->transforms + s * 12;
+        float m[12];
+        for (int i = 0; i < 12; i++) m[i] = m1[i] + (m2[i] - m1[i]) * t;
+        
+#if defined(_arch_dreamcast)
+        matrix_t matrix __attribute__((aligned(32))) = {
+            { m[0], m[4], m[8], 0.0f }, { m[1], m[5], m[9], 0.0f }, { m[2], m[6], m[10], 0.0f }, { m[3], m[7], m[11], 1.0f }
+        };
+        mat_load(&matrix);
+#endif
+        
+        for (; j < count && (int)vertices[j] < end; j++) {
+            const float *rest = keyframe1->rest + vertices[j] * 3;
+            float *position = (float*)((char*)output + (vertices[j] - firstVertex) * stride);
+            
+#if defined(_arch_dreamcast)
+            float x = rest[0], y = rest[1], z = rest[2];
+            mat_trans_single3_nodiv(x, y, z);
+            position[0] = x;
+            position[1] = y;
+            position[2] = z;
+#else
+            position[0] = m[0] * rest[0] + m[1] * rest[1] + m[2] * rest[2] + m[3];
+            position[1] = m[4] * rest[0] + m[5] * rest[1] + m[6] * rest[2] + m[7];
+            position[2] = m[8] * rest[0] + m[9] * rest[1] + m[10] * rest[2] + m[11];
+#endif
+        }
+    }
+}
+
+// Interpolate vertices [firstVertex, firstVertex + vertexCount) of two keyframes with the kernel
+// matching their storage (stride 0 = packed output)
+static void Anim4dcInterpolateKeyframes(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t, int firstVertex, int vertexCount) {
+    if (stride <= 0) stride = 3 * sizeof(float);
+    
+    if (keyframe1->moving) {
+        Anim4dcInterpolateSparse(output, stride, keyframe1, keyframe2, t, firstVertex, vertexCount);
+        if (keyframe1->transforms) Anim4dcTransformSegments(output, stride, keyframe1, keyframe2, t, firstVertex, vertexCount);
+    } else if (keyframe1->basis) {
+        Anim4dcInterpolateBasis(output, stride, keyframe1, keyframe2, t, firstVertex, vertexCount);
+    } else if (keyframe1->quantized) {
+        Anim4dcInterpolateQuantized(output, stride, keyframe1, keyframe2, t, firstVertex, vertexCount);
+    } else {
+        Anim4dcInterpolateVertices(output, stride, keyframe1->vertices + firstVertex * 3, 
+                                   keyframe2->vertices + firstVertex * 3, t, vertexCount);
+    }
+}
+
+// Crossfade two keyframe pairs of which at least one has rigid segments: ANIM4DC_RIGID_BLEND_CHUNK vertices
+// at a time, the first pair is interpolated into the output and the second on the stack, then blended over
+static void Anim4dcBlendRigid(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t1, 
+                              const Anim4dcVertexKeyframe *keyframe3, const Anim4dcVertexKeyframe *keyframe4, float t2, float weight, 
+                              int firstVertex, int vertexCount) {
+    float target[ANIM4DC_RIGID_BLEND_CHUNK * 3];
+    
+    for (int first = firstVertex; first < firstVertex + vertexCount; first += ANIM4DC_RIGID_BLEND_CHUNK) {
+        int count = firstVertex + vertexCount - first;
+        if (count > ANIM4DC_RIGID_BLEND_CHUNK) count = ANIM4DC_RIGID_BLEND_CHUNK;
+        
+        Anim4dcInterpolateKeyframes(output, stride, keyframe1, keyframe2, t1, first, count);
+        Anim4dcInterpolateKeyframes(target, 0, keyframe3, keyframe4, t2, first, count);
+        
+        for (int i = 0; i < count * 3; i += 3) {
+            output[0] += (target[i] - output[0]) * weight;
+            output[1] += (target[i + 1] - output[1]) * weight;
+            output[2] += (target[i + 2] - output[2]) * weight;
+            output = (float*)((char*)output + stride);
+        }
+    }
+}
+
+// Crossfade vertices [firstVertex, firstVertex + vertexCount) of two keyframe pairs with the kernel
+// matching their storage (stride 0 = packed output)
+static void Anim4dcBlendKeyframes(float *output, int stride, const Anim4dcVertexKeyframe *keyframe1, const Anim4dcVertexKeyframe *keyframe2, float t1, 
+                                  const Anim4dcVertexKeyframe *keyframe3, const Anim4dcVertexKeyframe *keyframe4, float t2, float weight, 
+                                  int firstVertex, int vertexCount) {
+    if (stride <= 0) stride = 3 * sizeof(float);
+    
+    if (keyframe1->transforms || keyframe3->transforms) {
+        Anim4dcBlendRigid(output, stride, keyframe1, keyframe2, t1, keyframe3, keyframe4, t2, weight, firstVertex, vertexCount);
+    } else if (keyframe1->moving || keyframe3->moving || keyframe1->basis || keyframe3->basis) {
+        Anim4dcBlendSampled(output, stride, keyframe1, keyframe2, t1, keyframe3, keyframe4, t2, weight, firstVertex, vertexCount);
+    } else if (keyframe1->quantized) {
+        Anim4dcBlendQuantized(output, stride, keyframe1, keyframe2, t1, keyframe3, keyframe4, t2, weight, firstVertex, vertexCount);
+    } else {
+        Anim4dcBlendVertices(output, stride, keyframe1->vertices + firstVertex * 3, keyframe2->vertices + firstVertex * 3, t1, 
+                             keyframe3->vertices + firstVertex * 3, keyframe4->vertices + firstVertex * 3, t2, weight, vertexCount);
+    }
+}
+
+// Mesh variant shown at a LOD level: the one baked for the nearest level at or above it (towards NEAR)
+// whose render model is loaded, 0 = full resolution
+static int Anim4dcGetLodVariant(const Anim4dcBakedModel *baked, Anim4dcLodLevel level) {
+    int variant = ((int)level < ANIM4DC_MAX_MESH_VARIANTS) ? (int)level : ANIM4DC_MAX_MESH_VARIANTS - 1;
+    for (; variant > 0; variant--) {
+        if (baked->variants[variant].model.meshCount > 0) return variant;
+    }
+    
+    return 0;
+}
+
+// Keyframes of an animation for a mesh variant (0 = full resolution); variant keyframes are stored in the
+// order of the full resolution ones, which sit back to back once packed or loaded
+static const Anim4dcVertexKeyframe *Anim4dcGetVariantKeyframes(const Anim4dcBakedModel *baked, int meshVariant, int animationIndex) {
+    const Anim4dcVertexKeyframe *keyframes = baked->animations[animationIndex].keyframes;
+    if (meshVariant <= 0) return keyframes;
+    
+    return baked->variants[meshVariant].keyframes + (keyframes - baked->animations[0].keyframes);
+}
+
+// Mesh blocks of a pose for a mesh variant (0 = full resolution)
+static const Anim4dcMeshRange *Anim4dcGetVariantRanges(const Anim4dcBakedModel *baked, int meshVariant) {
+    return (meshVariant > 0) ? baked->variants[meshVariant].meshes : baked->meshes;
+}
+
+// Vertices per pose of a mesh variant (0 = full resolution)
+static int Anim4dcGetVariantVertexCount(const Anim4dcBakedModel *baked, int meshVariant) {
+    return (meshVariant > 0) ? baked->variants[meshVariant].vertexCount : baked->vertexCount;
+}
+
+// Check that an instance's keyframe pairs (the fading one too while a fade runs) index its animations
+static bool Anim4dcCheckInstanceKeyframes(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance) {
+    int count = baked->animations[instance->animationIndex].keyframeCount;
+    if (instance->currentKeyframe < 0 || instance->currentKeyframe >= count || 
+        instance->nextKeyframe < 0 || instance->nextKeyframe >= count) {
+        return false;
+    }
+    if (instance->fadeDuration <= 0.0f) return true;
+    
+    if (instance->fadeAnimation < 0 || instance->fadeAnimation >= baked->animationCount) return false;
+    count = baked->animations[instance->fadeAnimation].keyframeCount;
+    return (instance->fadeKeyframe >= 0 && instance->fadeKeyframe < count && 
+            instance->fadeNextKeyframe >= 0 && instance->fadeNextKeyframe < count);
+}
+
+// Write vertices [firstVertex, firstVertex + vertexCount) of an instance's displayed pose for its mesh variant,
+// crossfaded from the animation fading out while a fade runs (keyframe pairs checked by the caller)
+static void Anim4dcWriteInstancePose(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance, float *output, int firstVertex, int vertexCount) {
+    const Anim4dcVertexKeyframe *keyframes = Anim4dcGetVariantKeyframes(baked, instance->meshVariant, instance->animationIndex);
+    
+    if (instance->fadeDuration <= 0.0f) {
+        Anim4dcInterpolateKeyframes(output, 0, &keyframes[instance->currentKeyframe], &keyframes[instance->nextKeyframe], 
+                                    instance->blendFactor, firstVertex, vertexCount);
+        return;
+    }
+    
+    const Anim4dcVertexKeyframe *fading = Anim4dcGetVariantKeyframes(baked, instance->meshVariant, instance->fadeAnimation);
+    Anim4dcBlendKeyframes(output, 0, &fading[instance->fadeKeyframe], &fading[instance->fadeNextKeyframe], instance->fadeBlendFactor, 
+                          &keyframes[instance->currentKeyframe], &keyframes[instance->nextKeyframe], instance->blendFactor, 
+                          instance->fadeElapsed / instance->fadeDuration, firstVertex, vertexCount);
+}
+
+// Upload a pose laid out by ranges (full resolution or a mesh variant's) into the matching meshes of a model
+static void Anim4dcUploadPose(Anim4dcBakedModel *baked, Model *model, const Anim4dcMeshRange *ranges, const float *positions) {
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Anim4dcMeshRange *range = &ranges[r];
+        if (range->meshIndex >= model->meshCount || model->meshes[range->meshIndex].vertexCount != range->vertexCount) continue;
+        
+        Anim4dcUploadMeshPositions(&model->meshes[range->meshIndex], positions + range->vertexOffset * 3);
+        baked->stats.meshUploads++;
+    }
+}
+
+// Detect evenly spaced keyframes so their index can be computed straight from time
+static void Anim4dcDetectKeyframeInterval(Anim4dcVertexAnimation *animation) {
+    animation->keyframeInterval = 0.0f;
+    if (animation->keyframeCount < 2 || animation->keyframes[0].timestamp != 0.0f) return;
+    
+    float interval = animation->keyframes[1].timestamp;
+    if (interval <= 0.0f) return;
+    
+    for (int k = 2; k < animation->keyframeCount; k++) {
+        if (fabsf(animation->keyframes[k].timestamp - k * interval) > interval * 0.001f) return;
+    }
+    
+    animation->keyframeInterval = interval;
+}
+
+// Find the keyframe pair around a playback time and the blend factor between them
+// currentKeyframe holds the caller's cursor on entry: it only moves forward, seeks fall back to binary search
+static void Anim4dcResolveKeyframes(const Anim4dcVertexAnimation *animation, float time, int *currentKeyframe, int *nextKeyframe, float *blend) {
+    const Anim4dcVertexKeyframe *keyframes = animation->keyframes;
+    int last = animation->keyframeCount - 1;
+    int current = *currentKeyframe;
+    int next = 0;
+    
+    if (last <= 0 || time <= keyframes[0].timestamp) {
+        current = 0;
+    } else if (time >= keyframes[last].timestamp) {
+        current = last;
+    } else {
+        if (animation->keyframeInterval > 0.0f) {
+            // Uniform sampling: index straight from time, nudged for float rounding below
+            current = (int)(time / animation->keyframeInterval);
+        } else if (current < 0 || current >= last || keyframes[current].timestamp > time) {
+            // Seek backwards (or loop wrap): binary search for the last keyframe at or before time
+            int low = 0;
+            int high = last;
+            while (high - low > 1) {
+                int mid = (low + high) / 2;
+                if (keyframes[mid].timestamp <= time) low = mid;
+                else high = mid;
+            }
+            current = low;
+        } else if (current + 2 <= last && keyframes[current + 2].timestamp <= time) {
+            // Jumped more than one keyframe ahead: search only what lies ahead of the cursor
+            int low = current + 2;
+            int high = last;
+            while (high - low > 1) {
+                int mid = (low + high) / 2;
+                if (keyframes[mid].timestamp <= time) low = mid;
+                else high = mid;
+            }
+            current = low;
+        }
+        
+        if (current < 0) current = 0;
+        if (current >= last) current = last - 1;
+        while (current < last - 1 && keyframes[current + 1].timestamp <= time) current++;
+        while (current > 0 && keyframes[current].timestamp > time) current--;
+    }
+    
+    // Past the last keyframe: loop back to the first one or hold the last pose
+    if (current == last) {
+        next = animation->looping ? 0 : last;
+    } else {
+        next = current + 1;
+    }
+    
+    // Calculate interpolation factor
+    float t1 = animation->keyframes[current].timestamp;
+    float t2 = (next <= current) ? animation->duration : animation->keyframes[next].timestamp;
+    float gap = t2 - t1;
+    float t = (gap > 0.0f) ? ((time - t1) / gap) : 0.0f;
+    
+    // Clamp interpolation factor
+    *blend = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+    *currentKeyframe = current;
+    *nextKeyframe = next;
+}
+
+// Wrap a playback time into a looping animation (remainder kept, so each clock holds its own phase) or clamp it
+static float Anim4dcWrapAnimationTime(const Anim4dcVertexAnimation *animation, float time) {
+    if (animation->looping) {
+        time = fmodf(time, animation->duration);
+        if (time < 0.0f) time += animation->duration;
+    } else if (time > animation->duration) {
+        time = animation->duration;
+    }
+    
+    return time;
+}
+
+// Write vertices [firstVertex, firstVertex + vertexCount) of the global playback pose, crossfaded while a fade runs
+static void Anim4dcWriteGlobalPose(const Anim4dcBakedModel *baked, float *output, int stride, int firstVertex, int vertexCount) {
+    const Anim4dcVertexAnimation *animation = &baked->animations[baked->currentAnimation];
+    int current = baked->currentKeyframe;
+    int next = 0;
+    float blend = 0.0f;
+    Anim4dcResolveKeyframes(animation, baked->currentTime, &current, &next, &blend);
+    
+    if (baked->fadeAnimation < 0 || baked->fadeDuration <= 0.0f) {
+        Anim4dcInterpolateKeyframes(output, stride, &animation->keyframes[current], &animation->keyframes[next], 
+                                    blend, firstVertex, vertexCount);
+        return;
+    }
+    
+    const Anim4dcVertexAnimation *fading = &baked->animations[baked->fadeAnimation];
+    int fadeCurrent = baked->fadeKeyframe;
+    int fadeNext = 0;
+    float fadeBlend = 0.0f;
+    Anim4dcResolveKeyframes(fading, baked->fadeTime, &fadeCurrent, &fadeNext, &fadeBlend);
+    
+    Anim4dcBlendKeyframes(output, stride, &fading->keyframes[fadeCurrent], &fading->keyframes[fadeNext], fadeBlend, 
+                          &animation->keyframes[current], &animation->keyframes[next], blend, 
+                          baked->fadeElapsed / baked->fadeDuration, firstVertex, vertexCount);
+}
+
+// Check that a policy's limits are positive and in band order
+static bool Anim4dcCheckLodPolicy(const Anim4dcLodPolicy *policy) {
+    bool rising = (policy->type == ANIM4DC_LOD_POLICY_DISTANCE);
+    if ((policy->type != ANIM4DC_LOD_POLICY_DISTANCE) && (policy->type != ANIM4DC_LOD_POLICY_SCREEN_SIZE)) return false;
+    
+    for (int k = 0; k < 4; k++) {
+        if (!(policy->limits[k] > 0.0f)) return false;
+        if ((k > 0) && (rising ? (policy->limits[k] <= policy->limits[k - 1]) : (policy->limits[k] >= policy->limits[k - 1]))) return false;
+    }
+    return true;
+}
+
+// LOD policy a model follows: its own, else the global one
+static Anim4dcLodPolicy Anim4dcResolveLodPolicy(const Anim4dcBakedModel *baked) {
+    return baked->hasLodPolicy ? baked->lodPolicy :
+           (anim4dc.initialized ? anim4dc.lodPolicy : Anim4dcGetDefaultLodPolicy());
+}
+
+// Turn the model's LOD policy into squared distance limits for this camera, moved in and out by the hysteresis
+// margins (clamped so neighbouring limits never cross). Screen sizes become distances for scale 1: a sphere of
+// radius r at distance d covers r * focal / d pixels, orthographic views drop the distance altogether
+static void Anim4dcPrepareLodLimits(Anim4dcBakedModel *baked, Camera3D camera) {
+    Anim4dcLodPolicy policy = Anim4dcResolveLodPolicy(baked);
+    const float *limits = policy.limits;
+    
+    float margins[4];
+    for (int k = 0; k < 4; k++) {
+        float gap = 0.5f * limits[k];
+        if (k > 0) gap = fminf(gap, 0.5f * fabsf(limits[k] - limits[k - 1]));
+        if (k < 3) gap = fminf(gap, 0.5f * fabsf(limits[k + 1] - limits[k]));
+        margins[k] = fminf(fmaxf(policy.hysteresis[k], 0.0f), gap);
+    }
+    
+    if (policy.type == ANIM4DC_LOD_POLICY_DISTANCE) {
+        for (int k = 0; k < 4; k++) {
+            baked->lodInnerLimits[k] = (limits[k] - margins[k]) * (limits[k] - margins[k]);
+            baked->lodOuterLimits[k] = (limits[k] + margins[k]) * (limits[k] + margins[k]);
+        }
+        baked->lodDistanceWeight = 1.0f;
+        baked->lodDistanceOffset = 0.0f;
+        baked->lodScaleWeight = 0.0f;
+        return;
+    }
+    
+    float height = (float)((policy.viewportHeight > 0) ? policy.viewportHeight : GetScreenHeight());
+    if (height <= 0.0f) height = 1.0f;
+    float radius = fmaxf(baked->boundsRadius, 1e-6f);
+    
+    // Orthographic size is radius * height / fovy at any distance, the constant metric (fovy / height)^2
+    // against (radius / pixels)^2 limits gives the same comparison
+    float focal = 1.0f;
+    baked->lodDistanceWeight = 0.0f;
+    baked->lodDistanceOffset = (camera.fovy / height) * (camera.fovy / height);
+    if (camera.projection != CAMERA_ORTHOGRAPHIC) {
+        focal = 0.5f * height / tanf(0.5f * camera.fovy * DEG2RAD);
+        baked->lodDistanceWeight = 1.0f;
+        baked->lodDistanceOffset = 0.0f;
+    }
+    baked->lodScaleWeight = 1.0f;
+    
+    // Larger on screen than the limit plus margin comes back in, smaller than the limit minus margin moves out
+    for (int k = 0; k < 4; k++) {
+        float inner = radius * focal / (limits[k] + margins[k]);
+        float outer = radius * focal / (limits[k] - margins[k]);
+        baked->lodInnerLimits[k] = inner * inner;
+        baked->lodOuterLimits[k] = outer * outer;
+    }
+}
+
+// LOD level every instance in a squared distance range gets, whatever its previous level and its scale within
+// minScale..maxScale (-1 = it depends on them)
+static int Anim4dcGetRangeLodLevel(const Anim4dcBakedModel *baked, float nearest, float farthest, float minScale, float maxScale) {
+    float nearMetric = nearest * baked->lodDistanceWeight + baked->lodDistanceOffset;
+    float farMetric = farthest * baked->lodDistanceWeight + baked->lodDistanceOffset;
+    float minLimitScale = 1.0f + baked->lodScaleWeight * (minScale * minScale - 1.0f);
+    float maxLimitScale = 1.0f + baked->lodScaleWeight * (maxScale * maxScale - 1.0f);
+    
+    int level = ANIM4DC_LOD_NEAR;
+    while ((level < ANIM4DC_LOD_CULLED) && (nearMetric > baked->lodOuterLimits[level] * maxLimitScale)) level++;
+    if ((level < ANIM4DC_LOD_CULLED) && (farMetric > baked->lodInnerLimits[level] * minLimitScale)) return -1;
+    return level;
+}
+
+// Get the animation speed multiplier for a LOD level
+static float Anim4dcGetLodSpeed(Anim4dcLodLevel lodLevel) {
+    switch (lodLevel) {
+        case ANIM4DC_LOD_NEAR: return ANIM4DC_LOD_NEAR_SPEED;
+        case ANIM4DC_LOD_MID: return ANIM4DC_LOD_MID_SPEED;
+        case ANIM4DC_LOD_FAR: return ANIM4DC_LOD_FAR_SPEED;
+        default: return ANIM4DC_LOD_FROZEN_SPEED;
+    }
+}
+
+// Get the pose update interval for a LOD level (0 = never)
+static int Anim4dcGetLodInterval(Anim4dcLodLevel lodLevel) {
+    switch (lodLevel) {
+        case ANIM4DC_LOD_NEAR: return ANIM4DC_LOD_NEAR_INTERVAL;
+        case ANIM4DC_LOD_MID: return ANIM4DC_LOD_MID_INTERVAL;
+        case ANIM4DC_LOD_FAR: return ANIM4DC_LOD_FAR_INTERVAL;
+        default: return ANIM4DC_LOD_FROZEN_INTERVAL;
+    }
+}
+
+// Extract the frustum planes (xyz = inward normal, w = distance) of a camera as BeginMode3D() sets it up
+// on the policy's render target (the screen for unset viewport sizes)
+static void Anim4dcExtractFrustum(Camera3D camera, const Anim4dcLodPolicy *policy, Vector4 planes[6]) {
+    int width = (policy->viewportWidth > 0) ? policy->viewportWidth : GetScreenWidth();
+    int height = (policy->viewportHeight > 0) ? policy->viewportHeight : GetScreenHeight();
+    float aspect = (width > 0 && height > 0) ? (float)width / (float)height : 1.0f;
+    Matrix projection;
+    if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+        double top = camera.fovy / 2.0;
+        double right = top * aspect;
+        projection = MatrixOrtho(-right, right, -top, top, ANIM4DC_FRUSTUM_NEAR, ANIM4DC_FRUSTUM_FAR);
+    } else {
+        projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect, ANIM4DC_FRUSTUM_NEAR, ANIM4DC_FRUSTUM_FAR);
+    }
+    Matrix m = MatrixMultiply(MatrixLookAt(camera.position, camera.target, camera.up), projection);
+    
+    // Rows of the view-projection matrix combine into the left, right, bottom, top, near and far planes
+    Vector4 rowX = { m.m0, m.m4, m.m8, m.m12 };
+    Vector4 rowY = { m.m1, m.m5, m.m9, m.m13 };
+    Vector4 rowZ = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 rowW = { m.m3, m.m7, m.m11, m.m15 };
+    const Vector4 *rows[3] = { &rowX, &rowY, &rowZ };
+    
+    for (int i = 0; i < 6; i++) {
+        const Vector4 *row = rows[i / 2];
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        Vector4 plane = { rowW.x + sign * row->x, rowW.y + sign * row->y, rowW.z + sign * row->z, rowW.w + sign * row->w };
+        
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane.x /= length;
+            plane.y /= length;
+            plane.z /= length;
+            plane.w /= length;
+        }
+        planes[i] = plane;
+    }
+}
+
+// Squared distances from a point to the nearest and farthest points of a box
+static void Anim4dcBoxDistanceRange(Vector3 point, Vector3 boxMin, Vector3 boxMax, float *nearest, float *farthest) {
+    const float *p = &point.x;
+    const float *low = &boxMin.x;
+    const float *high = &boxMax.x;
+    *nearest = 0.0f;
+    *farthest = 0.0f;
+    
+    for (int axis = 0; axis < 3; axis++) {
+        float below = low[axis] - p[axis];
+        float above = p[axis] - high[axis];
+        float gap = (below > 0.0f) ? below : ((above > 0.0f) ? above : 0.0f);
+        float span = (-below > -above) ? -below : -above;
+        *nearest += gap * gap;
+        *farthest += span * span;
+    }
+}
+
+// Clear the visibility counters before a LOD pass
+static void Anim4dcResetLodStats(Anim4dcBakedModel *baked) {
+    baked->stats.visibleInstances = 0;
+    baked->stats.culledInstances = 0;
+    baked->stats.frustumCulledInstances = 0;
+    baked->stats.lodInstanceTests = 0;
+    memset(baked->stats.lodTransitions, 0, sizeof(baked->stats.lodTransitions));
+}
+
+// Count instances classified alike into the visibility counters
+static void Anim4dcCountInstances(Anim4dcBakedModel *baked, Anim4dcLodLevel lodLevel, bool visible, int count) {
+    if (lodLevel == ANIM4DC_LOD_CULLED) baked->stats.culledInstances += count;
+    else if (visible) baked->stats.visibleInstances += count;
+    else baked->stats.frustumCulledInstances += count;
+}
+
+// Classify ANIM4DC_LOD_BATCH_SIZE structure-of-arrays instances (lodLevel holds the previous levels on entry),
+// level changes of the first count instances are added to transitions
+static void Anim4dcClassifyLodBatch(const Anim4dcBakedModel *baked, const float *ANIM4DC_RESTRICT x, const float *ANIM4DC_RESTRICT y,
+                                    const float *ANIM4DC_RESTRICT z, const float *ANIM4DC_RESTRICT scale, int count, Vector3 cameraPosition,
+                                    const Vector4 frustum[6], float *ANIM4DC_RESTRICT distanceSquared,
+                                    unsigned char *ANIM4DC_RESTRICT lodLevel, unsigned char *ANIM4DC_RESTRICT visible,
+                                    int transitions[ANIM4DC_LOD_CULLED + 1]) {
+    const float nearInner = baked->lodInnerLimits[0], nearOuter = baked->lodOuterLimits[0];
+    const float midInner = baked->lodInnerLimits[1], midOuter = baked->lodOuterLimits[1];
+    const float farInner = baked->lodInnerLimits[2], farOuter = baked->lodOuterLimits[2];
+    const float cullInner = baked->lodInnerLimits[3], cullOuter = baked->lodOuterLimits[3];
+    const float distanceWeight = baked->lodDistanceWeight;
+    const float distanceOffset = baked->lodDistanceOffset;
+    const float scaleWeight = baked->lodScaleWeight;
+    const Vector3 boundsCenter = baked->boundsCenter;
+    const float boundsRadius = baked->boundsRadius;
+    int entered[ANIM4DC_LOD_CULLED + 1] = { 0 };
+    Vector4 planes[6];
+    for (int p = 0; p < 6; p++) planes[p] = frustum[p];
+    
+    for (int i = 0; i < ANIM4DC_LOD_BATCH_SIZE; i++) {
+        // Calculate squared distance to avoid sqrt
+        float dx = x[i] - cameraPosition.x;
+        float dy = y[i] - cameraPosition.y;
+        float dz = z[i] - cameraPosition.z;
+        float d2 = dx * dx + dy * dy + dz * dz;
+        float s = scale[i];
+        
+        // Screen size limits grow with the instance: metric > limit * s^2 rather than dividing by it
+        float metric = d2 * distanceWeight + distanceOffset;
+        float limitScale = 1.0f + scaleWeight * (s * s - 1.0f);
+        int previous = lodLevel[i];
+        int level = ((metric > nearInner * limitScale) & (previous > 0)) | (metric > nearOuter * limitScale);
+        level += ((metric > midInner * limitScale) & (previous > 1)) | (metric > midOuter * limitScale);
+        level += ((metric > farInner * limitScale) & (previous > 2)) | (metric > farOuter * limitScale);
+        level += ((metric > cullInner * limitScale) & (previous > 3)) | (metric > cullOuter * limitScale);
+        int changed = (level != previous) & (i < count);
+        
+        // Off-screen instances keep their LOD level (and clock speed) but are neither posed nor drawn,
+        // the bounding sphere follows DrawModel() placement: position plus uniformly scaled model space
+        float cx = x[i] + boundsCenter.x * s;
+        float cy = y[i] + boundsCenter.y * s;
+        float cz = z[i] + boundsCenter.z * s;
+        float radius = boundsRadius * fabsf(s);
+        int inside = (level != ANIM4DC_LOD_CULLED);
+        inside &= (planes[0].x * cx + planes[0].y * cy + planes[0].z * cz + planes[0].w >= -radius);
+        inside &= (planes[1].x * cx + planes[1].y * cy + planes[1].z * cz + planes[1].w >= -radius);
+        inside &= (planes[2].x * cx + planes[2].y * cy + planes[2].z * cz + planes[2].w >= -radius);
+        inside &= (planes[3].x * cx + planes[3].y * cy + planes[3].z * cz + planes[3].w >= -radius);
+        inside &= (planes[4].x * cx + planes[4].y * cy + planes[4].z * cz + planes[4].w >= -radius);
+        inside &= (planes[5].x * cx + planes[5].y * cy + planes[5].z * cz + planes[5].w >= -radius);
+        
+        entered[0] += changed & (level == 0);
+        entered[1] += changed & (level == 1);
+        entered[2] += changed & (level == 2);
+        entered[3] += changed & (level == 3);
+        entered[4] += changed & (level == 4);
+        
+        distanceSquared[i] = d2;
+        lodLevel[i] = (unsigned char)level;
+        visible[i] = (unsigned char)inside;
+    }
+    
+    for (int t = 0; t <= ANIM4DC_LOD_CULLED; t++) transitions[t] += entered[t];
+}
+
+// Count a batch's classification into the visibility counters
+static void Anim4dcCountLodBatch(Anim4dcBakedModel *baked, const unsigned char *lodLevel, const unsigned char *visible, int count) {
+    int culled = 0;
+    int shown = 0;
+    for (int i = 0; i < count; i++) {
+        culled += (lodLevel[i] == ANIM4DC_LOD_CULLED);
+        shown += visible[i];
+    }
+    
+    baked->stats.culledInstances += culled;
+    baked->stats.visibleInstances += shown;
+    baked->stats.frustumCulledInstances += count - culled - shown;
+    baked->stats.lodInstanceTests += count;
+}
+
+// Classify Anim4dcModelInstances through the batch kernel, gathered and scattered ANIM4DC_LOD_BATCH_SIZE at a time
+// (indices picks which instances, NULL takes the first instanceCount in order)
+static void Anim4dcClassifyInstances(Anim4dcBakedModel *baked, Anim4dcModelInstance *instances, const int *indices, int instanceCount,
+                                     const Vector4 frustum[6], Vector3 cameraPosition) {
+    float x[ANIM4DC_LOD_BATCH_SIZE], y[ANIM4DC_LOD_BATCH_SIZE], z[ANIM4DC_LOD_BATCH_SIZE], scale[ANIM4DC_LOD_BATCH_SIZE];
+    float distanceSquared[ANIM4DC_LOD_BATCH_SIZE];
+    unsigned char lodLevel[ANIM4DC_LOD_BATCH_SIZE], visible[ANIM4DC_LOD_BATCH_SIZE];
+    
+    for (int first = 0; first < instanceCount; first += ANIM4DC_LOD_BATCH_SIZE) {
+        int count = (instanceCount - first < ANIM4DC_LOD_BATCH_SIZE) ? instanceCount - first : ANIM4DC_LOD_BATCH_SIZE;
+        
+        for (int i = 0; i < count; i++) {
+            const Anim4dcModelInstance *instance = &instances[indices ? indices[first + i] : first + i];
+            x[i] = instance->position.x;
+            y[i] = instance->position.y;
+            z[i] = instance->position.z;
+            scale[i] = instance->scale;
+            lodLevel[i] = (unsigned char)instance->lodLevel;
+        }
+        for (int i = count; i < ANIM4DC_LOD_BATCH_SIZE; i++) {
+            x[i] = y[i] = z[i] = scale[i] = 0.0f;
+            lodLevel[i] = ANIM4DC_LOD_NEAR;
+        }
+        
+        Anim4dcClassifyLodBatch(baked, x, y, z, scale, count, cameraPosition, frustum, distanceSquared, lodLevel, visible,
+                                baked->stats.lodTransitions);
+        Anim4dcCountLodBatch(baked, lodLevel, visible, count);
+        
+        for (int i = 0; i < count; i++) {
+            Anim4dcModelInstance *instance = &instances[indices ? indices[first + i] : first + i];
+            instance->distanceSquared = distanceSquared[i];
+            instance->lodLevel = (Anim4dcLodLevel)lodLevel[i];
+            instance->visible = (visible[i] != 0);
+        }
+    }
+}
+
+// Hash slot of a cell coordinate
+static int Anim4dcGridHash(const Anim4dcSpatialGrid *grid, int x, int y, int z) {
+    unsigned int hash = ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u) ^ ((unsigned int)z * 83492791u);
+    return (int)(hash & (unsigned int)(grid->tableSize - 1));
+}
+
+// Drop every cell and instance link
+static void Anim4dcClearSpatialGrid(Anim4dcSpatialGrid *grid) {
+    for (int t = 0; t < grid->tableSize; t++) grid->table[t] = -1;
+    for (int i = 0; i < grid->maxInstances; i++) {
+        grid->instanceCell[i] = -1;
+        grid->next[i] = -1;
+        grid->previous[i] = -1;
+    }
+    grid->cellCount = 0;
+    grid->occupiedCells = 0;
+    grid->instanceCount = 0;
+    grid->maxScale = 0.0f;
+    grid->minScale = FLT_MAX;
+}
+
+// Find the index of a cell, claiming a new one if the cell is not in the table yet
+// The caller keeps the table below ANIM4DC_GRID_MAX_LOAD so a free slot always exists
+static int Anim4dcFindGridCell(Anim4dcSpatialGrid *grid, int x, int y, int z) {
+    int slot = Anim4dcGridHash(grid, x, y, z);
+    while (grid->table[slot] >= 0) {
+        Anim4dcGridCell *cell = &grid->cells[grid->table[slot]];
+        if (cell->x == x && cell->y == y && cell->z == z) return grid->table[slot];
+        slot = (slot + 1) & (grid->tableSize - 1);
+    }
+    
+    grid->table[slot] = grid->cellCount;
+    Anim4dcGridCell *cell = &grid->cells[grid->cellCount];
+    cell->x = x;
+    cell->y = y;
+    cell->z = z;
+    cell->first = -1;
+    cell->count = 0;
+    cell->state = -1;
+    cell->inserted = 0;
+    return grid->cellCount++;
+}
+
+// Cell coordinates of a position
+static void Anim4dcGetGridCoords(const Anim4dcSpatialGrid *grid, Vector3 position, int *x, int *y, int *z) {
+    *x = (int)floorf(position.x / grid->cellSize);
+    *y = (int)floorf(position.y / grid->cellSize);
+    *z = (int)floorf(position.z / grid->cellSize);
+}
+
+// Link an instance into the cell of its position
+static void Anim4dcInsertGridInstance(Anim4dcSpatialGrid *grid, const Anim4dcModelInstance *instance, int index) {
+    int x, y, z;
+    Anim4dcGetGridCoords(grid, instance->position, &x, &y, &z);
+    int cellIndex = Anim4dcFindGridCell(grid, x, y, z);
+    Anim4dcGridCell *cell = &grid->cells[cellIndex];
+    
+    grid->next[index] = cell->first;
+    grid->previous[index] = -1;
+    if (cell->first >= 0) grid->previous[cell->first] = index;
+    cell->first = index;
+    
+    if (cell->count == 0) {
+        cell->boundsMin = cell->boundsMax = instance->position;
+        grid->occupiedCells++;
+    } else {
+        cell->boundsMin = Vector3Min(cell->boundsMin, instance->position);
+        cell->boundsMax = Vector3Max(cell->boundsMax, instance->position);
+    }
+    cell->count++;
+    cell->inserted++;
+    grid->instanceCell[index] = cellIndex;
+    
+    if (fabsf(instance->scale) > grid->maxScale) grid->maxScale = fabsf(instance->scale);
+    if (fabsf(instance->scale) < grid->minScale) grid->minScale = fabsf(instance->scale);
+}
+
+// Unlink an instance from its cell, an emptied cell stays claimed until the next rebuild
+static void Anim4dcRemoveGridInstance(Anim4dcSpatialGrid *grid, int index) {
+    int cellIndex = grid->instanceCell[index];
+    if (cellIndex < 0) return;
+    
+    Anim4dcGridCell *cell = &grid->cells[cellIndex];
+    if (grid->previous[index] >= 0) grid->next[grid->previous[index]] = grid->next[index];
+    else cell->first = grid->next[index];
+    if (grid->next[index] >= 0) grid->previous[grid->next[index]] = grid->previous[index];
+    
+    cell->count--;
+    if (cell->count == 0) grid->occupiedCells--;
+    
+    grid->instanceCell[index] = -1;
+    grid->next[index] = -1;
+    grid->previous[index] = -1;
+}
+
+// Allocate the pose cache on first use, models without instances never pay for it
+// Sized for the full resolution vertex count so poses of every mesh variant fit
+static bool Anim4dcAllocatePoseCache(Anim4dcBakedModel *baked) {
+    if (baked->poseCacheVertices) return true;
+    
+    baked->poseCacheVertices = (float*)malloc(ANIM4DC_POSE_CACHE_SIZE * baked->vertexCount * 3 * sizeof(float));
+    if (!baked->poseCacheVertices) {
+        // Pose cache is optional, instances fall back to their own interpolation without it
+        printf("Anim4DC: WARNING - Failed to allocate pose cache, instances will not share poses\n");
+        baked->poseQuantum = 0.0f;
+        return false;
+    }
+    
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) {
+        baked->poseCache[i].vertices = baked->poseCacheVertices + i * baked->vertexCount * 3;
+        baked->poseCache[i].animationIndex = -1;
+        baked->poseCache[i].meshVariant = 0;
+    }
+    return true;
+}
+
+// Find or create the shared pose for an animation and mesh variant at a quantized time
+// Returns -1 when every cache entry is already in use this frame
+static int Anim4dcAcquirePose(Anim4dcBakedModel *baked, int animationIndex, float time, int meshVariant) {
+    if (!baked->poseCacheVertices || baked->poseQuantum <= 0.0f) return -1;
+    
+    int timeStep = (int)(time / baked->poseQuantum);
+    int victim = -1;
+    
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) {
+        Anim4dcPoseCacheEntry *entry = &baked->poseCache[i];
+        
+        if (entry->animationIndex == animationIndex && entry->timeStep == timeStep && entry->meshVariant == meshVariant) {
+            entry->lastUsedFrame = baked->poseFrame;
+            baked->stats.poseCacheHits++;
+            return i;
+        }
+        
+        // Evict empty entries first, then the least recently used one not needed this frame
+        if (entry->lastUsedFrame == baked->poseFrame && entry->animationIndex >= 0) continue;
+        if (victim < 0 || entry->animationIndex < 0 || 
+            (baked->poseCache[victim].animationIndex >= 0 && entry->lastUsedFrame < baked->poseCache[victim].lastUsedFrame)) {
+            victim = i;
+        }
+    }
+    
+    baked->stats.poseCacheMisses++;
+    if (victim < 0) return -1;
+    
+    Anim4dcPoseCacheEntry *entry = &baked->poseCache[victim];
+    Anim4dcVertexAnimation *animation = &baked->animations[animationIndex];
+    int currentKeyframe = -1;
+    int nextKeyframe = 0;
+    float blend = 0.0f;
+    
+    const Anim4dcVertexKeyframe *keyframes = Anim4dcGetVariantKeyframes(baked, meshVariant, animationIndex);
+    int vertexCount = Anim4dcGetVariantVertexCount(baked, meshVariant);
+    
+    Anim4dcResolveKeyframes(animation, timeStep * baked->poseQuantum, &currentKeyframe, &nextKeyframe, &blend);
+    Anim4dcInterpolateKeyframes(entry->vertices, 0, &keyframes[currentKeyframe], &keyframes[nextKeyframe], blend, 0, vertexCount);
+    baked->stats.poseVertices += vertexCount;
+    
+    entry->animationIndex = animationIndex;
+    entry->timeStep = timeStep;
+    entry->meshVariant = meshVariant;
+    entry->lastUsedFrame = baked->poseFrame;
+    return victim;
+}
+
+// Capture a vertex keyframe from current skeletal animation state (staged until the arena is packed)
+static void Anim4dcCaptureVertexKeyframe(Anim4dcVertexAnimation *animation, float timestamp, float *vertexData, int vertexCount) {
+    Anim4dcVertexKeyframe *keyframe = &animation->keyframes[animation->keyframeCount];
+    
+    // Allocate memory for vertex data
+    int vertexDataSize = vertexCount * 3 * sizeof(float);
+    keyframe->vertices = (float*)malloc(vertexDataSize);
+    
+    if (keyframe->vertices) {
+        memcpy(keyframe->vertices, vertexData, vertexDataSize);
+        keyframe->vertexCount = vertexCount;
+        keyframe->timestamp = timestamp;
+        animation->keyframeCount++;
+    }
+}
+
+// Skin one whole source frame into a vertex buffer, frameCount wraps back to the first frame
+static void Anim4dcSkinSourceFrame(Anim4dcBakedModel *baked, Model model, ModelAnimation skelAnim, int frame, float *output, float *firstFrame, int vertexCount) {
+    if (frame >= skelAnim.frameCount) {
+        memcpy(output, firstFrame, vertexCount * 3 * sizeof(float));
+        return;
+    }
+    
+    UpdateModelAnimation(model, skelAnim, frame);
+    
+    // Each baked mesh lands in its own block of the keyframe
+    for (int r = 0; r < baked->meshCount; r++) {
+        Anim4dcMeshRange *range = &baked->meshes[r];
+        memcpy(output + range->vertexOffset * 3, model.meshes[range->meshIndex].animVertices, 
+               range->vertexCount * 3 * sizeof(float));
+    }
+}
+
+// Sample the source clip at a fractional frame position, in-between positions blend the two
+// neighbouring skinned frames (scratch holds the second one)
+static void Anim4dcSampleSourceFrame(Anim4dcBakedModel *baked, Model model, ModelAnimation skelAnim, float frame, float *output, float *firstFrame, float *scratch, int vertexCount) {
+    int frame0 = (int)frame;
+    float fraction = frame - frame0;
+    
+    Anim4dcSkinSourceFrame(baked, model, skelAnim, frame0, output, firstFrame, vertexCount);
+    if (fraction < 0.0001f || frame0 >= skelAnim.frameCount) return;
+    
+    Anim4dcSkinSourceFrame(baked, model, skelAnim, frame0 + 1, scratch, firstFrame, vertexCount);
+    Anim4dcInterpolateVertices(output, 3 * sizeof(float), output, scratch, fraction, vertexCount);
+}
+
+// Get the worst squared distance between a reference frame and the interpolation of two keyframes
+static float Anim4dcMeasureLerpError(float *reference, float *vertices1, float *vertices2, float t, int vertexCount) {
+    float worst = 0.0f;
+    
+    for (int i = 0; i < vertexCount * 3; i += 3) {
+        float dx = vertices1[i] + (vertices2[i] - vertices1[i]) * t - reference[i];
+        float dy = vertices1[i + 1] + (vertices2[i + 1] - vertices1[i + 1]) * t - reference[i + 1];
+        float dz = vertices1[i + 2] + (vertices2[i + 2] - vertices1[i + 2]) * t - reference[i + 2];
+        float distance = dx * dx + dy * dy + dz * dz;
+        if (distance > worst) worst = distance;
+    }
+    
+    return worst;
+}
+
+// Select and capture keyframes for one animation
+// Fixed mode keeps every Nth frame, adaptive mode greedily extends each segment while linear
+// interpolation stays within options.maxError of every source frame it replaces
+// Selection runs on samples at targetFrameRate (or the source frames), sample frameCount closes the loop
+static bool Anim4dcBakeKeyframes(Anim4dcBakedModel *baked, Model model, ModelAnimation skelAnim, Anim4dcVertexAnimation *vertAnim, 
+                                 Anim4dcBakeOptions options, Anim4dcBakeReport *report) {
+    int vertexCount = baked->vertexCount;
+    int floatsPerFrame = vertexCount * 3;
+    bool resample = (options.targetFrameRate > 0.0f);
+    float sourceRate = (options.sourceFrameRate > 0.0f) ? options.sourceFrameRate : ANIM4DC_SOURCE_FRAME_RATE;
+    float sampleRate = resample ? options.targetFrameRate : sourceRate;
+    float frameStep = sourceRate / sampleRate;      // Source frames per sample
+    int frameCount = resample ? (int)lrintf(vertAnim->duration * sampleRate) : skelAnim.frameCount;
+    if (frameCount < 1) frameCount = 1;
+    bool adaptive = (options.maxError > 0.0f);
+    bool measure = adaptive || (report != NULL);
+    int keyframeStep = resample ? 1 : ((frameCount > 40) ? 8 : 4);
+    int maxSpan = adaptive ? ANIM4DC_ADAPTIVE_MAX_SPAN : keyframeStep;
+    float maxErrorSqr = options.maxError * options.maxError;
+    
+    // Every keyframe starts at a distinct sample, so frameCount keyframes is the worst case
+    vertAnim->keyframes = (Anim4dcVertexKeyframe*)calloc(frameCount, sizeof(Anim4dcVertexKeyframe));
+    
+    // Window holds source frames [anchor, anchor + maxSpan], frame 'frameCount' closes the loop
+    float *window = (float*)malloc((maxSpan + 1) * floatsPerFrame * sizeof(float));
+    float *firstFrame = (float*)malloc(floatsPerFrame * sizeof(float));
+    float *scratch = (float*)malloc(floatsPerFrame * sizeof(float));
+    if (!vertAnim->keyframes || !window || !firstFrame || !scratch) {
+        printf("Anim4DC: ERROR - Failed to allocate keyframe selection buffers\n");
+        free(window);
+        free(firstFrame);
+        free(scratch);
+        return false;
+    }
+    
+    Anim4dcSampleSourceFrame(baked, model, skelAnim, 0.0f, firstFrame, NULL, scratch, vertexCount);
+    memcpy(window, firstFrame, floatsPerFrame * sizeof(float));
+    Anim4dcCaptureVertexKeyframe(vertAnim, 0.0f, window, vertexCount);
+    
+    float worstErrorSqr = 0.0f;
+    int anchor = 0;
+    int loaded = 0;
+    
+    while (anchor < frameCount) {
+        int end = anchor + 1;
+        float endErrorSqr = 0.0f;
+        
+        for (int candidate = anchor + 1; candidate <= frameCount && candidate - anchor <= maxSpan; candidate++) {
+            // Fixed stride without error reporting never needs the skipped frames
+            if (!measure && candidate - anchor < keyframeStep && candidate < frameCount) continue;
+            
+            float *candidateFrame = window + (candidate - anchor) * floatsPerFrame;
+            if (candidate > loaded) {
+                // The closing sample is the first frame again, not a resampled position near the end
+                if (candidate >= frameCount) {
+                    memcpy(candidateFrame, firstFrame, floatsPerFrame * sizeof(float));
+                } else {
+                    Anim4dcSampleSourceFrame(baked, model, skelAnim, candidate * frameStep, candidateFrame, firstFrame, scratch, vertexCount);
+                }
+                loaded = candidate;
+            }
+            
+            float segmentErrorSqr = 0.0f;
+            if (measure) {
+                for (int f = anchor + 1; f < candidate; f++) {
+                    float t = (float)(f - anchor) / (float)(candidate - anchor);
+                    float errorSqr = Anim4dcMeasureLerpError(window + (f - anchor) * floatsPerFrame, 
+                                                             window, candidateFrame, t, vertexCount);
+                    if (errorSqr > segmentErrorSqr) segmentErrorSqr = errorSqr;
+                    if (adaptive && segmentErrorSqr > maxErrorSqr) break;
+                }
+            }
+            
+            if (adaptive && segmentErrorSqr > maxErrorSqr && candidate > anchor + 1) break;
+            
+            end = candidate;
+            endErrorSqr = segmentErrorSqr;
+        }
+        
+        if (endErrorSqr > worstErrorSqr) worstErrorSqr = endErrorSqr;
+        if (end >= frameCount) break;
+        
+        // Slide the window so the new anchor (and any frames sampled past it) start at slot 0
+        memmove(window, window + (end - anchor) * floatsPerFrame, (loaded - end + 1) * floatsPerFrame * sizeof(float));
+        anchor = end;
+        Anim4dcCaptureVertexKeyframe(vertAnim, anchor / sampleRate, window, vertexCount);
+    }
+    
+    free(window);
+    free(firstFrame);
+    free(scratch);
+    
+    if (report) {
+        report->sourceFrames = skelAnim.frameCount;
+        report->duration = vertAnim->duration;
+        report->keyframeCount = vertAnim->keyframeCount;
+        report->maxError = sqrtf(worstErrorSqr);
+    }
+    
+    if (measure) {
+        printf("Anim4DC: Baked %d/%d keyframes for %s (max error %.4f)\n", 
+               vertAnim->keyframeCount, frameCount, vertAnim->name, sqrtf(worstErrorSqr));
+    } else {
+        printf("Anim4DC: Baked %d keyframes for %s\n", vertAnim->keyframeCount, vertAnim->name);
+    }
+    
+    return true;
+}
+
+// Drop baked meshes whose keyframes never leave the bind pose, rendering them needs no animation
+// Remaining mesh blocks move down so every keyframe stays contiguous
+static void Anim4dcSkipStaticMeshes(Anim4dcBakedModel *baked, Model model) {
+    int kept = 0;
+    int vertexOffset = 0;
+    
+    for (int r = 0; r < baked->meshCount; r++) {
+        Anim4dcMeshRange range = baked->meshes[r];
+        float *bindPose = model.meshes[range.meshIndex].vertices;
+        bool moves = (bindPose == NULL);
+        
+        for (int a = 0; a < baked->animationCount && !moves; a++) {
+            for (int k = 0; k < baked->animations[a].keyframeCount && !moves; k++) {
+                float *vertices = baked->animations[a].keyframes[k].vertices + range.vertexOffset * 3;
+                for (int i = 0; i < range.vertexCount * 3; i++) {
+                    if (fabsf(vertices[i] - bindPose[i]) > ANIM4DC_STATIC_EPSILON) {
+                        moves = true;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        if (!moves) {
+            printf("Anim4DC: Mesh %d is static, skipping its keyframes\n", range.meshIndex);
+            continue;
+        }
+        
+        if (range.vertexOffset != vertexOffset) {
+            for (int a = 0; a < baked->animationCount; a++) {
+                for (int k = 0; k < baked->animations[a].keyframeCount; k++) {
+                    float *vertices = baked->animations[a].keyframes[k].vertices;
+                    memmove(vertices + vertexOffset * 3, vertices + range.vertexOffset * 3, range.vertexCount * 3 * sizeof(float));
+                }
+            }
+            range.vertexOffset = vertexOffset;
+        }
+        
+        baked->meshes[kept++] = range;
+        vertexOffset += range.vertexCount;
+    }
+    
+    if (kept == baked->meshCount) return;
+    
+    baked->meshCount = kept;
+    baked->vertexCount = vertexOffset;
+    
+    // Staged keyframes keep their blocks, packing the arena only copies the kept vertices
+    for (int a = 0; a < baked->animationCount; a++) {
+        for (int k = 0; k < baked->animations[a].keyframeCount; k++) {
+            baked->animations[a].keyframes[k].vertexCount = vertexOffset;
+        }
+    }
+}
+
+// Gather the bind pose of the baked meshes, the rest pose sparse and rigid keyframes are stored against
+// *restPose stays NULL when a mesh has none (keyframes then stay absolute), false = allocation failure
+static bool Anim4dcBuildRestPose(const Anim4dcBakedModel *baked, Model model, float **restPose) {
+    *restPose = NULL;
+    
+    for (int r = 0; r < baked->meshCount; r++) {
+        if (model.meshes[baked->meshes[r].meshIndex].vertices == NULL) {
+            printf("Anim4DC: WARNING - Mesh %d has no bind pose, keyframes stay absolute\n", baked->meshes[r].meshIndex);
+            return true;
+        }
+    }
+    
+    *restPose = (float*)malloc(baked->vertexCount * 3 * sizeof(float));
+    if (!*restPose) {
+        printf("Anim4DC: ERROR - Failed to allocate the rest pose\n");
+        return false;
+    }
+    
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Anim4dcMeshRange *range = &baked->meshes[r];
+        memcpy(*restPose + range->vertexOffset * 3, model.meshes[range->meshIndex].vertices, range->vertexCount * 3 * sizeof(float));
+    }
+    
+    return true;
+}
+
+// Store animations as deltas from the bind pose, dropping vertices that stay within threshold of it for a whole clip
+// An animation goes sparse only when at most ANIM4DC_SPARSE_MAX_MOVING of its vertices move, the rest stay dense absolute
+// Runs on the staged float keyframes after mesh variants were gathered from them, reports get each clip's moving count
+static bool Anim4dcEncodeSparseAnimations(Anim4dcBakedModel *baked, Model model, float threshold, Anim4dcBakeReport *reports) {
+    int vertexCount = baked->vertexCount;
+    float thresholdSqr = threshold * threshold;
+    
+    float *restPose = NULL;
+    if (!Anim4dcBuildRestPose(baked, model, &restPose)) return false;
+    if (!restPose) return true;
+    
+    unsigned char *moves = (unsigned char*)malloc(vertexCount);
+    if (!moves) {
+        printf("Anim4DC: ERROR - Failed to allocate the rest pose\n");
+        free(restPose);
+        return false;
+    }
+    
+    bool sparse = false;
+    bool success = true;
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        Anim4dcVertexAnimation *animation = &baked->animations[a];
+        int movingCount = 0;
+        memset(moves, 0, vertexCount);
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            const float *vertices = animation->keyframes[k].vertices;
+            for (int i = 0; i < vertexCount; i++) {
+                if (moves[i]) continue;
+                
+                float dx = vertices[i * 3] - restPose[i * 3];
+                float dy = vertices[i * 3 + 1] - restPose[i * 3 + 1];
+                float dz = vertices[i * 3 + 2] - restPose[i * 3 + 2];
+                if (dx * dx + dy * dy + dz * dz > thresholdSqr) {
+                    moves[i] = 1;
+                    movingCount++;
+                }
+            }
+        }
+        
+        if (movingCount > vertexCount * ANIM4DC_SPARSE_MAX_MOVING) continue;
+        
+        // At least one entry each, a clip where nothing moves keeps empty keyframes
+        animation->movingVertices = (uint32_t*)malloc((movingCount > 0 ? movingCount : 1) * sizeof(uint32_t));
+        if (!animation->movingVertices) {
+            success = false;
+            break;
+        }
+        animation->movingCount = 0;
+        for (int i = 0; i < vertexCount; i++) {
+            if (moves[i]) animation->movingVertices[animation->movingCount++] = i;
+        }
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            Anim4dcVertexKeyframe *keyframe = &animation->keyframes[k];
+            float *deltas = (float*)malloc((movingCount > 0 ? movingCount : 1) * 3 * sizeof(float));
+            if (!deltas) {
+                success = false;
+                break;
+            }
+            
+            for (int j = 0; j < movingCount; j++) {
+                int i = animation->movingVertices[j];
+                for (int c = 0; c < 3; c++) deltas[j * 3 + c] = keyframe->vertices[i * 3 + c] - restPose[i * 3 + c];
+            }
+            
+            free(keyframe->vertices);
+            keyframe->vertices = deltas;
+            keyframe->vertexCount = movingCount;
+            keyframe->rest = restPose;
+            keyframe->moving = animation->movingVertices;
+        }
+        
+        sparse = true;
+        if (reports) reports[a].movingVertices = movingCount;
+        printf("Anim4DC: %s moves %d of %d vertices, storing their deltas from the bind pose\n", animation->name, movingCount, vertexCount);
+    }
+    
+    free(moves);
+    
+    // The staged model owns the rest pose as soon as a keyframe points at it
+    if (sparse) baked->restPose = restPose;
+    else free(restPose);
+    
+    if (!success) printf("Anim4DC: ERROR - Failed to allocate sparse keyframes\n");
+    return success;
+}
+
+//----------------------------------------------------------------------------------
+// Mesh Welding
+//----------------------------------------------------------------------------------
+// Loaders often emit one vertex per triangle corner. Welding merges vertices whose every attribute matches,
+// indexes the triangles, orders them for the post-transform vertex cache (Forsyth's linear-speed optimizer)
+// and renumbers vertices in first use order, so keyframes only store, interpolate and upload unique vertices
+
+#define ANIM4DC_VERTEX_STREAMS      10          // Per-vertex attribute arrays of a raylib mesh
+
+// One per-vertex attribute array of a mesh
+typedef struct Anim4dcVertexStream {
+    void **data;                // Mesh field holding the array
+    int size;                   // Bytes per vertex
+    bool compare;               // Part of a vertex's identity (the animated copies are not)
+} Anim4dcVertexStream;
+
+// Skinned meshes are the ones raylib animates and the bake captures
+static bool Anim4dcIsSkinnedMesh(const Mesh *mesh) {
+    return (mesh->boneIds && mesh->boneWeights && mesh->animVertices && mesh->vertexCount > 0);
+}
+
+static void Anim4dcGetVertexStreams(Mesh *mesh, Anim4dcVertexStream *streams) {
+    Anim4dcVertexStream all[ANIM4DC_VERTEX_STREAMS] = {
+        { (void**)&mesh->vertices, 3 * sizeof(float), true },
+        { (void**)&mesh->texcoords, 2 * sizeof(float), true },
+        { (void**)&mesh->texcoords2, 2 * sizeof(float), true },
+        { (void**)&mesh->normals, 3 * sizeof(float), true },
+        { (void**)&mesh->tangents, 4 * sizeof(float), true },
+        { (void**)&mesh->colors, 4 * sizeof(unsigned char), true },
+        { (void**)&mesh->boneIds, 4 * sizeof(unsigned char), true },
+        { (void**)&mesh->boneWeights, 4 * sizeof(float), true },
+        { (void**)&mesh->animVertices, 3 * sizeof(float), false },
+        { (void**)&mesh->animNormals, 3 * sizeof(float), false }
+    };
+    memcpy(streams, all, sizeof(all));
+}
+
+// Hash the compared attributes of a vertex (FNV-1a over their bytes)
+static uint32_t Anim4dcHashVertex(const Anim4dcVertexStream *streams, int vertex) {
+    uint32_t hash = 2166136261u;
+    
+    for (int s = 0; s < ANIM4DC_VERTEX_STREAMS; s++) {
+        if (!streams[s].compare || !*streams[s].data) continue;
+        
+        const unsigned char *bytes = (const unsigned char*)*streams[s].data + vertex * streams[s].size;
+        for (int b = 0; b < streams[s].size; b++) hash = (hash ^ bytes[b]) * 16777619u;
+    }
+    
+    return hash;
+}
+
+static bool Anim4dcSameVertex(const Anim4dcVertexStream *streams, int a, int b) {
+    for (int s = 0; s < ANIM4DC_VERTEX_STREAMS; s++) {
+        if (!streams[s].compare || !*streams[s].data) continue;
+        
+        const unsigned char *bytes = (const unsigned char*)*streams[s].data;
+        if (memcmp(bytes + a * streams[s].size, bytes + b * streams[s].size, streams[s].size) != 0) return false;
+    }
+    
+    return true;
+}
+
+// Score of a vertex for the next triangle: recently used vertices are likely still cached,
+// vertices with few triangles left are worth finishing so they leave the cache for good
+static float Anim4dcVertexCacheScore(int cachePosition, int remaining) {
+    if (remaining <= 0) return -1.0f;
+    
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // The last triangle's vertices score lower, its neighbours would reuse them in a strip-like order anyway
+        if (cachePosition < 3) score = 0.75f;
+        else score = powf(1.0f - (float)(cachePosition - 3) / (ANIM4DC_VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+    
+    return score + 2.0f / sqrtf((float)remaining);
+}
+
+// Reorder triangles (never their corners) for a ANIM4DC_VERTEX_CACHE_SIZE entry post-transform cache
+static bool Anim4dcOptimizeVertexCache(int *indices, int triangleCount, int vertexCount) {
+    int indexCount = triangleCount * 3;
+    int *remaining = (int*)calloc(vertexCount, sizeof(int));           // Triangles left to emit per vertex
+    int *adjacencyStart = (int*)malloc((vertexCount + 1) * sizeof(int));
+    int *adjacency = (int*)malloc((indexCount + 1) * sizeof(int));     // Triangles left per vertex, emitted ones swapped out
+    int *cachePosition = (int*)malloc(vertexCount * sizeof(int));
+    float *vertexScore = (float*)malloc(vertexCount * sizeof(float));
+    float *triangleScore = (float*)malloc((triangleCount + 1) * sizeof(float));
+    bool *emitted = (bool*)calloc(triangleCount + 1, sizeof(bool));
+    int *output = (int*)malloc((indexCount + 1) * sizeof(int));
+    
+    bool success = (remaining && adjacencyStart && adjacency && cachePosition && vertexScore && triangleScore && emitted && output);
+    if (success) {
+        for (int c = 0; c < indexCount; c++) remaining[indices[c]]++;
+        
+        adjacencyStart[0] = 0;
+        for (int v = 0; v < vertexCount; v++) {
+            adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+            remaining[v] = 0;
+        }
+        for (int c = 0; c < indexCount; c++) {
+            int v = indices[c];
+            adjacency[adjacencyStart[v] + remaining[v]++] = c / 3;
+        }
+        
+        for (int v = 0; v < vertexCount; v++) {
+            cachePosition[v] = -1;
+            vertexScore[v] = Anim4dcVertexCacheScore(-1, remaining[v]);
+        }
+        
+        int best = -1;
+        for (int t = 0; t < triangleCount; t++) {
+            triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+            if (best < 0 || triangleScore[t] > triangleScore[best]) best = t;
+        }
+        
+        int cache[ANIM4DC_VERTEX_CACHE_SIZE + 3];
+        int cacheCount = 0;
+        
+        for (int emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+            // Nothing left around the cache: restart from the best triangle anywhere
+            if (best < 0) {
+                for (int t = 0; t < triangleCount; t++) {
+                    if (!emitted[t] && (best < 0 || triangleScore[t] > triangleScore[best])) best = t;
+                }
+            }
+            
+            const int *triangle = &indices[best * 3];
+            memcpy(&output[emittedCount * 3], triangle, 3 * sizeof(int));
+            emitted[best] = true;
+            
+            for (int k = 0; k < 3; k++) {
+                int v = triangle[k];
+                int *list = &adjacency[adjacencyStart[v]];
+                for (int j = 0; j < remaining[v]; j++) {
+                    if (list[j] == best) {
+                        list[j] = list[--remaining[v]];
+                        break;
+                    }
+                }
+            }
+            
+            // The triangle's vertices move to the front, the rest shift back and the overflow drops out
+            int newCache[ANIM4DC_VERTEX_CACHE_SIZE + 3];
+            int newCount = 0;
+            for (int k = 0; k < 3; k++) newCache[newCount++] = triangle[k];
+            for (int i = 0; i < cacheCount; i++) {
+                int v = cache[i];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) newCache[newCount++] = v;
+            }
+            
+            for (int i = 0; i < newCount; i++) {
+                int v = newCache[i];
+                cachePosition[v] = (i < ANIM4DC_VERTEX_CACHE_SIZE) ? i : -1;
+                vertexScore[v] = Anim4dcVertexCacheScore(cachePosition[v], remaining[v]);
+            }
+            cacheCount = (newCount < ANIM4DC_VERTEX_CACHE_SIZE) ? newCount : ANIM4DC_VERTEX_CACHE_SIZE;
+            memcpy(cache, newCache, cacheCount * sizeof(int));
+            
+            // Only triangles around the rescored vertices changed, the best of them goes next
+            best = -1;
+            for (int i = 0; i < newCount; i++) {
+                int v = newCache[i];
+                for (int j = 0; j < remaining[v]; j++) {
+                    int t = adjacency[adjacencyStart[v] + j];
+                    triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                    if (best < 0 || triangleScore[t] > triangleScore[best]) best = t;
+                }
+            }
+        }
+        
+        memcpy(indices, output, indexCount * sizeof(int));
+    } else {
+        printf("Anim4DC: ERROR - Failed to allocate vertex cache optimization state\n");
+    }
+    
+    free(remaining);
+    free(adjacencyStart);
+    free(adjacency);
+    free(cachePosition);
+    free(vertexScore);
+    free(triangleScore);
+    free(emitted);
+    free(output);
+    return success;
+}
+
+// Weld a mesh in place into unique vertices and cache ordered 16-bit indexed triangles, then re-upload it
+// if it was uploaded; the mesh is left as it was when it cannot be welded
+static bool Anim4dcWeldMesh(Mesh *mesh, int meshIndex) {
+    int vertexCount = mesh->vertexCount;
+    int triangleCount = mesh->indices ? mesh->triangleCount : vertexCount / 3;
+    Anim4dcVertexStream streams[ANIM4DC_VERTEX_STREAMS];
+    Anim4dcGetVertexStreams(mesh, streams);
+    
+    int tableSize = 1;
+    while (tableSize < vertexCount * 2) tableSize <<= 1;
+    int *table = (int*)malloc(tableSize * sizeof(int));
+    int *weldOf = (int*)malloc(vertexCount * sizeof(int));             // Welded vertex of each mesh vertex
+    int *first = (int*)malloc(vertexCount * sizeof(int));              // First mesh vertex of each welded vertex
+    int *order = (int*)malloc(vertexCount * sizeof(int));              // Final index of each welded vertex
+    int *indices = (int*)malloc((triangleCount * 3 + 1) * sizeof(int));
+    
+    if (!table || !weldOf || !first || !order || !indices) {
+        printf("Anim4DC: ERROR - Failed to allocate mesh welding state\n");
+        free(table);
+        free(weldOf);
+        free(first);
+        free(order);
+        free(indices);
+        return false;
+    }
+    
+    memset(table, -1, tableSize * sizeof(int));
+    int weldedCount = 0;
+    
+    for (int i = 0; i < vertexCount; i++) {
+        int slot = (int)(Anim4dcHashVertex(streams, i) & (uint32_t)(tableSize - 1));
+        while (table[slot] >= 0 && !Anim4dcSameVertex(streams, first[table[slot]], i)) slot = (slot + 1) & (tableSize - 1);
+        
+        if (table[slot] < 0) {
+            table[slot] = weldedCount;
+            first[weldedCount++] = i;
+        }
+        weldOf[i] = table[slot];
+    }
+    
+    // Triangles with two corners on one vertex have nothing to draw once welded
+    int indexCount = 0;
+    for (int t = 0; t < triangleCount; t++) {
+        int corners[3];
+        bool valid = true;
+        for (int k = 0; k < 3; k++) {
+            int source = mesh->indices ? mesh->indices[t * 3 + k] : t * 3 + k;
+            valid = valid && (source < vertexCount);
+            corners[k] = valid ? weldOf[source] : -1;
+        }
+        if (!valid || corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) continue;
+        
+        memcpy(&indices[indexCount], corners, 3 * sizeof(int));
+        indexCount += 3;
+    }
+    
+    bool success = Anim4dcOptimizeVertexCache(indices, indexCount / 3, weldedCount);
+    
+    // Vertices are renumbered in first use order (unreferenced ones are dropped), which also
+    // keeps the fetches of consecutive triangles close together
+    memset(order, -1, weldedCount * sizeof(int));
+    int uniqueCount = 0;
+    for (int c = 0; c < indexCount; c++) {
+        int welded = indices[c];
+        if (order[welded] < 0) {
+            order[welded] = uniqueCount;
+            weldOf[uniqueCount++] = first[welded];      // weldOf now maps final vertices to mesh vertices
+        }
+        indices[c] = order[welded];
+    }
+    
+    if (success && uniqueCount > 65536) {
+        printf("Anim4DC: WARNING - Mesh %d keeps %d vertices once welded, too many for 16-bit indices\n", meshIndex, uniqueCount);
+        success = false;
+    }
+    
+    Mesh welded = { 0 };
+    Anim4dcVertexStream weldedStreams[ANIM4DC_VERTEX_STREAMS];
+    Anim4dcGetVertexStreams(&welded, weldedStreams);
+    
+    if (success) {
+        welded.vertexCount = uniqueCount;
+        welded.triangleCount = indexCount / 3;
+        welded.indices = (unsigned short*)MemAlloc(indexCount * sizeof(unsigned short));
+        success = (welded.indices != NULL);
+        
+        for (int s = 0; s < ANIM4DC_VERTEX_STREAMS && success; s++) {
+            if (!*streams[s].data) continue;
+            
+            unsigned char *data = (unsigned char*)MemAlloc(uniqueCount * streams[s].size);
+            const unsigned char *source = (const unsigned char*)*streams[s].data;
+            *weldedStreams[s].data = data;
+            success = (data != NULL);
+            
+            for (int i = 0; i < uniqueCount && success; i++) {
+                memcpy(data + i * streams[s].size, source + weldOf[i] * streams[s].size, streams[s].size);
+            }
+        }
+        
+        if (success) {
+            for (int c = 0; c < indexCount; c++) welded.indices[c] = (unsigned short)indices[c];
+        } else {
+            printf("Anim4DC: ERROR - Failed to allocate welded mesh %d\n", meshIndex);
+            UnloadMesh(welded);
+        }
+    }
+    
+    free(table);
+    free(weldOf);
+    free(first);
+    free(order);
+    free(indices);
+    if (!success) return false;
+    
+    printf("Anim4DC: Welded mesh %d: %d -> %d vertices, %d triangles\n", meshIndex, vertexCount, uniqueCount, welded.triangleCount);
+    
+    // GPU skinning matrices stay with the mesh, everything else is replaced
+    welded.boneMatrices = mesh->boneMatrices;
+    welded.boneCount = mesh->boneCount;
+    bool uploaded = (mesh->vboId != NULL);
+    
+    Mesh source = *mesh;
+    source.boneMatrices = NULL;
+    UnloadMesh(source);
+    
+    *mesh = welded;
+    if (uploaded) UploadMesh(mesh, true);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Mesh Decimation
+//----------------------------------------------------------------------------------
+// Half-edge collapses on the bind pose: a vertex merges into one of its neighbours, so every vertex left
+// is an original one and variant keyframes just gather positions from the full resolution keyframes.
+// Positions are welded first (texture seams stay split), collapses run cheapest first by quadric error
+// and any collapse that would fold a triangle over is skipped
+
+// Collapse queued in the decimation heap, stale once its vertex's version moves on
+typedef struct Anim4dcCollapse {
+    double cost;                // Quadric error of the merged vertex
+    int vertex;                 // Welded vertex merged away
+    int version;                // Version of the vertex the collapse was computed for
+} Anim4dcCollapse;
+
+// Decimation state of one mesh, welded vertices are indexed apart from the mesh's own vertices
+typedef struct Anim4dcDecimator {
+    const float *positions;     // Bind pose of the mesh
+    int cornerCount;            // Three per triangle
+    int *cornerSource;          // Mesh vertex each triangle corner referenced originally
+    int *cornerVertex;          // Welded vertex each corner points at now
+    int *cornerNext;            // Next corner of the same welded vertex (-1 = last)
+    bool *triangleDead;         // Triangles that lost an edge to a collapse
+    int *weldOf;                // Welded vertex of each mesh vertex
+    int *keep;                  // Mesh vertex a variant keeps for each one (first one sharing its position and texcoords)
+    int *first;                 // First mesh vertex of each welded vertex, collapsed corners keep it
+    int *classes;               // Kept mesh vertices behind each welded vertex
+    int *head;                  // Corner list of each welded vertex (-1 = none)
+    int *tail;
+    int *target;                // Neighbour each welded vertex collapses into best (-1 = none)
+    int *version;               // Bumped whenever target is recomputed
+    int *visited;               // Collapse that last recomputed each welded vertex
+    bool *removed;              // Collapsed away
+    double *quadrics;           // 10 per welded vertex, area weighted sum of its triangles' planes
+    Anim4dcCollapse *heap;      // Min heap of pending collapses
+    int heapCount;
+    int heapCapacity;
+    int liveVertices;           // Kept mesh vertices of the welded vertices still referenced
+    int collapses;              // Collapses done
+} Anim4dcDecimator;
+
+// Free a decimator's arrays
+static void Anim4dcFreeDecimator(Anim4dcDecimator *decimator) {
+    free(decimator->cornerSource);
+    free(decimator->cornerVertex);
+    free(decimator->cornerNext);
+    free(decimator->triangleDead);
+    free(decimator->weldOf);
+    free(decimator->keep);
+    free(decimator->first);
+    free(decimator->classes);
+    free(decimator->head);
+    free(decimator->tail);
+    free(decimator->target);
+    free(decimator->version);
+    free(decimator->visited);
+    free(decimator->removed);
+    free(decimator->quadrics);
+    free(decimator->heap);
+    memset(decimator, 0, sizeof(Anim4dcDecimator));
+}
+
+// Position of a welded vertex
+static Vector3 Anim4dcWeldedPosition(const Anim4dcDecimator *decimator, int vertex) {
+    const float *p = decimator->positions + decimator->first[vertex] * 3;
+    return (Vector3){ p[0], p[1], p[2] };
+}
+
+// Squared distance of a point to the planes summed in a quadric
+static double Anim4dcQuadricError(const double *q, Vector3 p) {
+    double x = p.x, y = p.y, z = p.z;
+    return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x +
+           q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y +
+           q[7] * z * z + 2.0 * q[8] * z + q[9];
+}
+
+// Queue a collapse, the heap grows as needed
+static bool Anim4dcPushCollapse(Anim4dcDecimator *decimator, Anim4dcCollapse collapse) {
+    if (decimator->heapCount == decimator->heapCapacity) {
+        int capacity = decimator->heapCapacity * 2;
+        Anim4dcCollapse *heap = (Anim4dcCollapse*)realloc(decimator->heap, capacity * sizeof(Anim4dcCollapse));
+        if (!heap) {
+            printf("Anim4DC: ERROR - Failed to grow the decimation heap\n");
+            return false;
+        }
+        decimator->heap = heap;
+        decimator->heapCapacity = capacity;
+    }
+    
+    int i = decimator->heapCount++;
+    while (i > 0 && decimator->heap[(i - 1) / 2].cost > collapse.cost) {
+        decimator->heap[i] = decimator->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    decimator->heap[i] = collapse;
+    return true;
+}
+
+// Take the cheapest queued collapse
+static Anim4dcCollapse Anim4dcPopCollapse(Anim4dcDecimator *decimator) {
+    Anim4dcCollapse top = decimator->heap[0];
+    Anim4dcCollapse last = decimator->heap[--decimator->heapCount];
+    int i = 0;
+    
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= decimator->heapCount) break;
+        if (child + 1 < decimator->heapCount && decimator->heap[child + 1].cost < decimator->heap[child].cost) child++;
+        if (decimator->heap[child].cost >= last.cost) break;
+        decimator->heap[i] = decimator->heap[child];
+        i = child;
+    }
+    if (decimator->heapCount > 0) decimator->heap[i] = last;
+    
+    return top;
+}
+
+// Check that moving welded vertex u onto v keeps every triangle that survives the collapse facing the same way
+static bool Anim4dcCollapseKeepsNormals(const Anim4dcDecimator *decimator, int u, int v) {
+    Vector3 to = Anim4dcWeldedPosition(decimator, v);
+    
+    for (int c = decimator->head[u]; c >= 0; c = decimator->cornerNext[c]) {
+        int base = (c / 3) * 3;
+        const int *vertices = &decimator->cornerVertex[base];
+        if (decimator->triangleDead[c / 3] || vertices[0] == v || vertices[1] == v || vertices[2] == v) continue;
+        
+        Vector3 before[3], after[3];
+        for (int k = 0; k < 3; k++) {
+            before[k] = Anim4dcWeldedPosition(decimator, vertices[k]);
+            after[k] = (vertices[k] == u) ? to : before[k];
+        }
+        
+        Vector3 normalBefore = Vector3CrossProduct(Vector3Subtract(before[1], before[0]), Vector3Subtract(before[2], before[0]));
+        Vector3 normalAfter = Vector3CrossProduct(Vector3Subtract(after[1], after[0]), Vector3Subtract(after[2], after[0]));
+        float lengthAfter = Vector3Length(normalAfter);
+        if (lengthAfter <= 0.0f || 
+            Vector3DotProduct(normalBefore, normalAfter) < ANIM4DC_DECIMATE_MIN_DOT * Vector3Length(normalBefore) * lengthAfter) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Find the cheapest valid collapse of a welded vertex into one of its neighbours and queue it
+static bool Anim4dcUpdateCollapse(Anim4dcDecimator *decimator, int u) {
+    double bestCost = DBL_MAX;
+    int best = -1;
+    
+    for (int c = decimator->head[u]; c >= 0; c = decimator->cornerNext[c]) {
+        if (decimator->triangleDead[c / 3]) continue;
+        
+        for (int k = 0; k < 3; k++) {
+            int v = decimator->cornerVertex[(c / 3) * 3 + k];
+            if (v == u) continue;
+            
+            double q[10];
+            for (int i = 0; i < 10; i++) q[i] = decimator->quadrics[u * 10 + i] + decimator->quadrics[v * 10 + i];
+            double cost = Anim4dcQuadricError(q, Anim4dcWeldedPosition(decimator, v));
+            
+            if (cost < bestCost && Anim4dcCollapseKeepsNormals(decimator, u, v)) {
+                bestCost = cost;
+                best = v;
+            }
+        }
+    }
+    
+    decimator->target[u] = best;
+    decimator->version[u]++;
+    if (best < 0) return true;
+    
+    Anim4dcCollapse collapse = { bestCost, u, decimator->version[u] };
+    return Anim4dcPushCollapse(decimator, collapse);
+}
+
+// Weld a mesh's vertices, build its corner lists and plane quadrics and queue every vertex's best collapse
+static bool Anim4dcInitDecimator(Anim4dcDecimator *decimator, const Mesh *mesh) {
+    memset(decimator, 0, sizeof(Anim4dcDecimator));
+    
+    int vertexCount = mesh->vertexCount;
+    int triangleCount = mesh->indices ? mesh->triangleCount : vertexCount / 3;
+    decimator->positions = mesh->vertices;
+    decimator->cornerCount = triangleCount * 3;
+    decimator->heapCapacity = vertexCount * 2 + 16;
+    
+    decimator->cornerSource = (int*)malloc(decimator->cornerCount * sizeof(int));
+    decimator->cornerVertex = (int*)malloc(decimator->cornerCount * sizeof(int));
+    decimator->cornerNext = (int*)malloc(decimator->cornerCount * sizeof(int));
+    decimator->triangleDead = (bool*)calloc(triangleCount, sizeof(bool));
+    decimator->weldOf = (int*)malloc(vertexCount * sizeof(int));
+    decimator->keep = (int*)malloc(vertexCount * sizeof(int));
+    decimator->first = (int*)malloc(vertexCount * sizeof(int));
+    decimator->classes = (int*)calloc(vertexCount, sizeof(int));
+    decimator->head = (int*)malloc(vertexCount * sizeof(int));
+    decimator->tail = (int*)malloc(vertexCount * sizeof(int));
+    decimator->target = (int*)malloc(vertexCount * sizeof(int));
+    decimator->version = (int*)calloc(vertexCount, sizeof(int));
+    decimator->visited = (int*)calloc(vertexCount, sizeof(int));
+    decimator->removed = (bool*)calloc(vertexCount, sizeof(bool));
+    decimator->quadrics = (double*)calloc(vertexCount * 10, sizeof(double));
+    decimator->heap = (Anim4dcCollapse*)malloc(decimator->heapCapacity * sizeof(Anim4dcCollapse));
+    
+    // Weld hash of positions, members chains each welded vertex's mesh vertices
+    int tableSize = 1;
+    while (tableSize < vertexCount * 2) tableSize <<= 1;
+    int *table = (int*)malloc(tableSize * sizeof(int));
+    int *members = (int*)malloc(vertexCount * sizeof(int));
+    
+    if (!decimator->cornerSource || !decimator->cornerVertex || !decimator->cornerNext || !decimator->triangleDead ||
+        !decimator->weldOf || !decimator->keep || !decimator->first || !decimator->classes || !decimator->head ||
+        !decimator->tail || !decimator->target || !decimator->version || !decimator->visited || !decimator->removed ||
+        !decimator->quadrics || !decimator->heap || !table || !members) {
+        printf("Anim4DC: ERROR - Failed to allocate mesh decimation state\n");
+        free(table);
+        free(members);
+        Anim4dcFreeDecimator(decimator);
+        return false;
+    }
+    
+    memset(table, -1, tableSize * sizeof(int));
+    int weldedCount = 0;
+    
+    for (int i = 0; i < vertexCount; i++) {
+        const float *p = mesh->vertices + i * 3;
+        uint32_t bits[3] = { 0 };
+        for (int c = 0; c < 3; c++) {
+            if (p[c] != 0.0f) memcpy(&bits[c], &p[c], sizeof(uint32_t));   // -0 welds with 0
+        }
+        
+        int slot = (int)((bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u) & (uint32_t)(tableSize - 1));
+        int welded = -1;
+        while (table[slot] >= 0) {
+            const float *q = mesh->vertices + decimator->first[table[slot]] * 3;
+            if (q[0] == p[0] && q[1] == p[1] && q[2] == p[2]) {
+                welded = table[slot];
+                break;
+            }
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        
+        decimator->keep[i] = i;
+        members[i] = -1;
+        if (welded < 0) {
+            welded = weldedCount++;
+            table[slot] = welded;
+            decimator->first[welded] = i;
+            decimator->tail[welded] = i;
+            decimator->classes[welded] = 1;
+        } else {
+            // Texture seams keep one vertex per distinct texcoord
+            for (int j = decimator->first[welded]; j >= 0; j = members[j]) {
+                if (!mesh->texcoords || (mesh->texcoords[j * 2] == mesh->texcoords[i * 2] && 
+                                         mesh->texcoords[j * 2 + 1] == mesh->texcoords[i * 2 + 1])) {
+                    decimator->keep[i] = decimator->keep[j];
+                    break;
+                }
+            }
+            if (decimator->keep[i] == i) decimator->classes[welded]++;
+            members[decimator->tail[welded]] = i;
+            decimator->tail[welded] = i;
+        }
+        decimator->weldOf[i] = welded;
+    }
+    free(table);
+    free(members);
+    
+    // Corner lists per welded vertex
+    for (int v = 0; v < weldedCount; v++) {
+        decimator->head[v] = -1;
+        decimator->tail[v] = -1;
+    }
+    for (int c = 0; c < decimator->cornerCount; c++) {
+        int source = mesh->indices ? mesh->indices[c] : c;
+        if (source >= vertexCount) {
+            printf("Anim4DC: ERROR - Mesh index %d out of range, cannot decimate\n", source);
+            Anim4dcFreeDecimator(decimator);
+            return false;
+        }
+        
+        int v = decimator->weldOf[source];
+        decimator->cornerSource[c] = source;
+        decimator->cornerVertex[c] = v;
+        decimator->cornerNext[c] = -1;
+        if (decimator->head[v] < 0) decimator->head[v] = c;
+        else decimator->cornerNext[decimator->tail[v]] = c;
+        decimator->tail[v] = c;
+    }
+    
+    // Area weighted plane quadrics, triangles already collapsed by welding are dead from the start
+    for (int t = 0; t < triangleCount; t++) {
+        const int *vertices = &decimator->cornerVertex[t * 3];
+        if (vertices[0] == vertices[1] || vertices[1] == vertices[2] || vertices[0] == vertices[2]) {
+            decimator->triangleDead[t] = true;
+            continue;
+        }
+        
+        Vector3 p0 = Anim4dcWeldedPosition(decimator, vertices[0]);
+        Vector3 normal = Vector3CrossProduct(Vector3Subtract(Anim4dcWeldedPosition(decimator, vertices[1]), p0), 
+                                             Vector3Subtract(Anim4dcWeldedPosition(decimator, vertices[2]), p0));
+        float length = Vector3Length(normal);
+        if (length <= 0.0f) continue;
+        
+        double area = length * 0.5;
+        double a = normal.x / length, b = normal.y / length, c = normal.z / length;
+        double d = -(a * p0.x + b * p0.y + c * p0.z);
+        double plane[10] = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+        
+        for (int k = 0; k < 3; k++) {
+            for (int i = 0; i < 10; i++) decimator->quadrics[vertices[k] * 10 + i] += plane[i] * area;
+        }
+    }
+    
+    for (int v = 0; v < weldedCount; v++) {
+        if (decimator->head[v] < 0) continue;
+        decimator->liveVertices += decimator->classes[v];
+        if (!Anim4dcUpdateCollapse(decimator, v)) {
+            Anim4dcFreeDecimator(decimator);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Merge welded vertex u into v, then requeue every vertex whose triangles changed
+static bool Anim4dcCollapseVertex(Anim4dcDecimator *decimator, int u, int v) {
+    for (int i = 0; i < 10; i++) decimator->quadrics[v * 10 + i] += decimator->quadrics[u * 10 + i];
+    
+    for (int c = decimator->head[u]; c >= 0; c = decimator->cornerNext[c]) decimator->cornerVertex[c] = v;
+    for (int c = decimator->head[u]; c >= 0; c = decimator->cornerNext[c]) {
+        const int *vertices = &decimator->cornerVertex[(c / 3) * 3];
+        if (vertices[0] == vertices[1] || vertices[1] == vertices[2] || vertices[0] == vertices[2]) decimator->triangleDead[c / 3] = true;
+    }
+    
+    if (decimator->head[v] < 0) decimator->head[v] = decimator->head[u];
+    else decimator->cornerNext[decimator->tail[v]] = decimator->head[u];
+    decimator->tail[v] = decimator->tail[u];
+    decimator->head[u] = -1;
+    decimator->tail[u] = -1;
+    decimator->removed[u] = true;
+    decimator->liveVertices -= decimator->classes[u];
+    decimator->collapses++;
+    
+    // v's triangles (the ones that just died included) hold every vertex whose neighbourhood changed
+    for (int c = decimator->head[v]; c >= 0; c = decimator->cornerNext[c]) {
+        for (int k = 0; k < 3; k++) {
+            int w = decimator->cornerVertex[(c / 3) * 3 + k];
+            if (decimator->removed[w] || decimator->visited[w] == decimator->collapses) continue;
+            
+            decimator->visited[w] = decimator->collapses;
+            if (!Anim4dcUpdateCollapse(decimator, w)) return false;
+        }
+    }
+    
+    return true;
+}
+
+// Collapse until at most targetVertices kept vertices are left or no valid collapse remains
+static bool Anim4dcDecimate(Anim4dcDecimator *decimator, int targetVertices) {
+    while (decimator->liveVertices > targetVertices && decimator->heapCount > 0) {
+        Anim4dcCollapse collapse = Anim4dcPopCollapse(decimator);
+        int u = collapse.vertex;
+        if (decimator->removed[u] || collapse.version != decimator->version[u]) continue;
+        
+        // The neighbour went away since this collapse was queued
+        if (decimator->removed[decimator->target[u]]) {
+            if (!Anim4dcUpdateCollapse(decimator, u)) return false;
+            continue;
+        }
+        
+        if (!Anim4dcCollapseVertex(decimator, u, decimator->target[u])) return false;
+    }
+    
+    return true;
+}
+
+// Append a decimated mesh's surviving triangles to a mesh variant as block rangeIndex, one variant vertex
+// per kept mesh vertex in first use order (remap holds -1 for every mesh vertex and is left that way)
+static void Anim4dcEmitMeshVariant(const Anim4dcDecimator *decimator, Anim4dcMeshVariant *variant, Anim4dcMeshRange range, int rangeIndex, int *remap) {
+    int vertexCount = 0;
+    int indexCount = 0;
+    uint32_t *sources = variant->sourceVertices + variant->vertexCount;
+    unsigned short *indices = variant->indices + variant->indexCount;
+    
+    for (int c = 0; c < decimator->cornerCount; c++) {
+        if (decimator->triangleDead[c / 3]) continue;
+        
+        // Corners that stayed put keep their own seam vertex, collapsed ones take their new vertex's first
+        int v = decimator->cornerVertex[c];
+        int source = decimator->cornerSource[c];
+        int kept = (decimator->weldOf[source] == v) ? decimator->keep[source] : decimator->first[v];
+        
+        if (remap[kept] < 0) {
+            remap[kept] = vertexCount;
+            sources[vertexCount++] = range.vertexOffset + kept;
+        }
+        indices[indexCount++] = (unsigned short)remap[kept];
+    }
+    
+    for (int i = 0; i < vertexCount; i++) remap[sources[i] - range.vertexOffset] = -1;
+    
+    variant->meshes[rangeIndex].meshIndex = range.meshIndex;
+    variant->meshes[rangeIndex].vertexOffset = variant->vertexCount;
+    variant->meshes[rangeIndex].vertexCount = vertexCount;
+    variant->indexCounts[rangeIndex] = indexCount;
+    variant->vertexCount += vertexCount;
+    variant->indexCount += indexCount;
+}
+
+// Decimate the baked meshes for each LOD level with a target vertex count (MID, FAR, FROZEN), splitting the
+// target across meshes by vertex count, then gather each variant's keyframes from the staged float keyframes
+static bool Anim4dcBuildMeshVariants(Anim4dcBakedModel *baked, Model model, const int *targets) {
+    bool requested = false;
+    for (int level = ANIM4DC_LOD_MID; level < ANIM4DC_MAX_MESH_VARIANTS; level++) {
+        if (targets[level - 1] > 0) requested = true;
+    }
+    if (!requested) return true;
+    
+    int cornerCount = 0;
+    int maxVertices = 0;
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Mesh *mesh = &model.meshes[baked->meshes[r].meshIndex];
+        if (!mesh->vertices || mesh->vertexCount > 65536) {
+            printf("Anim4DC: ERROR - Mesh %d cannot be decimated (no bind pose or over 65536 vertices)\n", baked->meshes[r].meshIndex);
+            return false;
+        }
+        cornerCount += mesh->indices ? mesh->triangleCount * 3 : (mesh->vertexCount / 3) * 3;
+        if (mesh->vertexCount > maxVertices) maxVertices = mesh->vertexCount;
+    }
+    
+    for (int level = ANIM4DC_LOD_MID; level < ANIM4DC_MAX_MESH_VARIANTS; level++) {
+        if (targets[level - 1] <= 0) continue;
+        
+        Anim4dcMeshVariant *variant = &baked->variants[level];
+        variant->sourceVertices = (uint32_t*)malloc(baked->vertexCount * sizeof(uint32_t));
+        variant->indices = (unsigned short*)malloc(cornerCount * sizeof(unsigned short));
+        if (!variant->sourceVertices || !variant->indices) {
+            printf("Anim4DC: ERROR - Failed to allocate mesh variant\n");
+            return false;
+        }
+    }
+    
+    int *remap = (int*)malloc(maxVertices * sizeof(int));
+    if (!remap) {
+        printf("Anim4DC: ERROR - Failed to allocate mesh variant\n");
+        return false;
+    }
+    memset(remap, -1, maxVertices * sizeof(int));
+    
+    // One decimation per mesh serves every level, from the largest target down
+    for (int r = 0; r < baked->meshCount; r++) {
+        Anim4dcDecimator decimator;
+        if (!Anim4dcInitDecimator(&decimator, &model.meshes[baked->meshes[r].meshIndex])) {
+            free(remap);
+            return false;
+        }
+        
+        for (int level = ANIM4DC_LOD_MID; level < ANIM4DC_MAX_MESH_VARIANTS; level++) {
+            if (targets[level - 1] <= 0) continue;
+            
+            int meshTarget = (int)((long long)targets[level - 1] * baked->meshes[r].vertexCount / baked->vertexCount);
+            if (!Anim4dcDecimate(&decimator, (meshTarget > 3) ? meshTarget : 3)) {
+                Anim4dcFreeDecimator(&decimator);
+                free(remap);
+                return false;
+            }
+            Anim4dcEmitMeshVariant(&decimator, &baked->variants[level], baked->meshes[r], r, remap);
+        }
+        Anim4dcFreeDecimator(&decimator);
+    }
+    free(remap);
+    
+    int keyframeCount = 0;
+    for (int a = 0; a < baked->animationCount; a++) keyframeCount += baked->animations[a].keyframeCount;
+    
+    for (int level = ANIM4DC_LOD_MID; level < ANIM4DC_MAX_MESH_VARIANTS; level++) {
+        Anim4dcMeshVariant *variant = &baked->variants[level];
+        if (targets[level - 1] <= 0) continue;
+        
+        variant->keyframes = (Anim4dcVertexKeyframe*)calloc(keyframeCount, sizeof(Anim4dcVertexKeyframe));
+        if (!variant->keyframes || variant->vertexCount == 0) {
+            printf("Anim4DC: ERROR - Failed to build the LOD %d mesh variant\n", level);
+            return false;
+        }
+        
+        Anim4dcVertexKeyframe *keyframe = variant->keyframes;
+        for (int a = 0; a < baked->animationCount; a++) {
+            for (int k = 0; k < baked->animations[a].keyframeCount; k++, keyframe++) {
+                const float *full = baked->animations[a].keyframes[k].vertices;
+                keyframe->vertices = (float*)malloc(variant->vertexCount * 3 * sizeof(float));
+                if (!keyframe->vertices) {
+                    printf("Anim4DC: ERROR - Failed to allocate mesh variant keyframe\n");
+                    return false;
+                }
+                
+                for (int i = 0; i < variant->vertexCount; i++) memcpy(keyframe->vertices + i * 3, full + variant->sourceVertices[i] * 3, 3 * sizeof(float));
+                keyframe->vertexCount = variant->vertexCount;
+                keyframe->timestamp = baked->animations[a].keyframes[k].timestamp;
+            }
+        }
+        
+        printf("Anim4DC: LOD %d mesh variant: %d vertices, %d triangles (full %d vertices)\n", 
+               level, variant->vertexCount, variant->indexCount / 3, baked->vertexCount);
+    }
+    
+    return true;
+}
+
+// Build one decimated mesh of a variant from the full resolution mesh's attributes and upload it,
+// positions start at the bind pose until the first pose is written
+static bool Anim4dcBuildVariantMesh(const Anim4dcMeshVariant *variant, int rangeIndex, const Anim4dcMeshRange *fullRange, 
+                                    const Mesh *source, const unsigned short *indices, Mesh *mesh) {
+    const Anim4dcMeshRange *range = &variant->meshes[rangeIndex];
+    const uint32_t *sources = variant->sourceVertices + range->vertexOffset;
+    int vertexCount = range->vertexCount;
+    
+    memset(mesh, 0, sizeof(Mesh));
+    mesh->vertexCount = vertexCount;
+    mesh->triangleCount = variant->indexCounts[rangeIndex] / 3;
+    mesh->vertices = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
+    mesh->indices = (unsigned short*)MemAlloc(variant->indexCounts[rangeIndex] * sizeof(unsigned short));
+    if (source->texcoords) mesh->texcoords = (float*)MemAlloc(vertexCount * 2 * sizeof(float));
+    if (source->texcoords2) mesh->texcoords2 = (float*)MemAlloc(vertexCount * 2 * sizeof(float));
+    if (source->normals) mesh->normals = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
+    if (source->tangents) mesh->tangents = (float*)MemAlloc(vertexCount * 4 * sizeof(float));
+    if (source->colors) mesh->colors = (unsigned char*)MemAlloc(vertexCount * 4 * sizeof(unsigned char));
+    
+    if (!mesh->vertices || !mesh->indices || (source->texcoords && !mesh->texcoords) || (source->texcoords2 && !mesh->texcoords2) ||
+        (source->normals && !mesh->normals) || (source->tangents && !mesh->tangents) || (source->colors && !mesh->colors)) {
+        UnloadMesh(*mesh);
+        memset(mesh, 0, sizeof(Mesh));
+        return false;
+    }
+    
+    for (int i = 0; i < vertexCount; i++) {
+        int s = sources[i] - fullRange->vertexOffset;
+        memcpy(mesh->vertices + i * 3, source->vertices + s * 3, 3 * sizeof(float));
+        if (mesh->texcoords) memcpy(mesh->texcoords + i * 2, source->texcoords + s * 2, 2 * sizeof(float));
+        if (mesh->texcoords2) memcpy(mesh->texcoords2 + i * 2, source->texcoords2 + s * 2, 2 * sizeof(float));
+        if (mesh->normals) memcpy(mesh->normals + i * 3, source->normals + s * 3, 3 * sizeof(float));
+        if (mesh->tangents) memcpy(mesh->tangents + i * 4, source->tangents + s * 4, 4 * sizeof(float));
+        if (mesh->colors) memcpy(mesh->colors + i * 4, source->colors + s * 4, 4 * sizeof(unsigned char));
+    }
+    memcpy(mesh->indices, indices, variant->indexCounts[rangeIndex] * sizeof(unsigned short));
+    
+    // Positions change every pose, the rest never does
+    UploadMesh(mesh, true);
+    return true;
+}
+
+// Free a mesh variant's render model: its decimated meshes and its own mesh and material index arrays
+// (materials and static meshes belong to the model it was built from)
+static void Anim4dcFreeVariantModel(const Anim4dcBakedModel *baked, Model *model) {
+    if (model->meshes) {
+        for (int r = 0; r < baked->meshCount; r++) {
+            Mesh *mesh = &model->meshes[baked->meshes[r].meshIndex];
+            if (mesh->vertices) UnloadMesh(*mesh);
+        }
+    }
+    MemFree(model->meshes);
+    MemFree(model->meshMaterial);
+    memset(model, 0, sizeof(Model));
+}
+
+// Allocate an empty baked model and add it to the live model list
+static Anim4dcBakedModel *Anim4dcCreateBakedModel(void) {
+    Anim4dcBakedModel *baked = (Anim4dcBakedModel*)calloc(1, sizeof(Anim4dcBakedModel));
+    if (!baked) {
+        printf("Anim4DC: ERROR - Failed to allocate baked model\n");
+        return NULL;
+    }
+    
+    baked->currentAnimation = -1;
+    baked->fadeAnimation = -1;
+    baked->poseQuantum = ANIM4DC_POSE_QUANTUM;
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) baked->poseCache[i].animationIndex = -1;
+    
+    baked->next = anim4dc.models;
+    anim4dc.models = baked;
+    return baked;
+}
+
+// Free the per-keyframe allocations of a bake that never reached its arena
+static void Anim4dcFreeStagedAnimations(Anim4dcBakedModel *baked) {
+    if (!baked->animations) return;
+    
+    int keyframeCount = 0;
+    for (int a = 0; a < baked->animationCount; a++) keyframeCount += baked->animations[a].keyframeCount;
+    
+    for (int v = 0; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        Anim4dcMeshVariant *variant = &baked->variants[v];
+        if (variant->keyframes) {
+            for (int k = 0; k < keyframeCount; k++) {
+                free(variant->keyframes[k].vertices);
+                free(variant->keyframes[k].quantized);
+            }
+            free(variant->keyframes);
+        }
+        free(variant->sourceVertices);
+        free(variant->indices);
+    }
+    
+    for (int a = 0; a < baked->animationCount; a++) {
+        Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->keyframes) continue;
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            free(animation->keyframes[k].vertices);
+            free(animation->keyframes[k].quantized);
+        }
+        free(animation->keyframes);
+        free(animation->movingVertices);
+        free(animation->basis);
+        free(animation->coefficients);
+        free(animation->segmentStarts);
+        free(animation->transforms);
+    }
+    free(baked->animations);
+    free(baked->restPose);
+}
+
+// Free baked or loaded animation data and the interpolation buffer
+static void Anim4dcUnloadAnimations(Anim4dcBakedModel *baked) {
+    Anim4dcUnloadMeshVariants(baked);
+    
+    // Packed or loaded models hold every animation, keyframe, vertex block and mesh variant in the arena
+    if (baked->arena) {
+        free(baked->arena);
+    } else {
+        Anim4dcFreeStagedAnimations(baked);
+    }
+    baked->arena = NULL;
+    baked->arenaSize = 0;
+    baked->animations = NULL;
+    baked->restPose = NULL;
+    memset(baked->variants, 0, sizeof(baked->variants));
+    
+    // Free interpolation buffer, a registered destination is only valid for the model it was set up for
+    if (baked->interpolationBuffer) {
+        free(baked->interpolationBuffer);
+        baked->interpolationBuffer = NULL;
+    }
+    baked->outputVertices = NULL;
+    baked->outputStride = 0;
+    baked->outputMeshes = NULL;
+    
+    // Free pose cache
+    free(baked->poseCacheVertices);
+    baked->poseCacheVertices = NULL;
+    memset(baked->poseCache, 0, sizeof(baked->poseCache));
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) baked->poseCache[i].animationIndex = -1;
+    
+    baked->animationCount = 0;
+    baked->vertexCount = 0;
+    memset(baked->meshes, 0, sizeof(baked->meshes));
+    baked->meshCount = 0;
+    baked->storage = ANIM4DC_STORAGE_FLOAT;
+    baked->currentAnimation = -1;
+    baked->currentTime = 0.0f;
+    baked->currentKeyframe = 0;
+    baked->fadeAnimation = -1;
+}
+
+// Get the bounding box of a float keyframe's stored positions (or deltas)
+static void Anim4dcKeyframeBounds(const Anim4dcVertexKeyframe *keyframe, Vector3 *boxMin, Vector3 *boxMax) {
+    const float *vertices = keyframe->vertices;
+    if (keyframe->vertexCount <= 0) {
+        *boxMin = *boxMax = (Vector3){ 0.0f, 0.0f, 0.0f };
+        return;
+    }
+    *boxMin = *boxMax = (Vector3){ vertices[0], vertices[1], vertices[2] };
+    
+    for (int i = 3; i < keyframe->vertexCount * 3; i += 3) {
+        Vector3 v = { vertices[i], vertices[i + 1], vertices[i + 2] };
+        *boxMin = Vector3Min(*boxMin, v);
+        *boxMax = Vector3Max(*boxMax, v);
+    }
+}
+
+// Bounding sphere around every keyframe of every animation, INT16 keyframes use their dequantization box
+// Sparse keyframes cover the whole rest pose (their static vertices) plus each moving vertex decoded,
+// basis compressed ones each vertex reconstructed and rigid ones each segment vertex transformed
+static void Anim4dcComputeBounds(Anim4dcBakedModel *baked) {
+    Vector3 boundsMin = { 0 };
+    Vector3 boundsMax = { 0 };
+    Vector3 restMin = { 0 };
+    Vector3 restMax = { 0 };
+    bool first = true;
+    
+    if (baked->restPose) {
+        Anim4dcVertexKeyframe rest = { 0 };
+        rest.vertices = baked->restPose;
+        rest.vertexCount = baked->vertexCount;
+        Anim4dcKeyframeBounds(&rest, &restMin, &restMax);
+    }
+    
+    for (int a = 0; a < baked->animationCount; a++) {
+        for (int k = 0; k < baked->animations[a].keyframeCount; k++) {
+            const Anim4dcVertexKeyframe *keyframe = &baked->animations[a].keyframes[k];
+            Vector3 keyMin, keyMax;
+            
+            if (keyframe->moving || keyframe->basis) {
+                Anim4dcPairSampler sampler;
+                Anim4dcPreparePair(&sampler, keyframe, keyframe, 0.0f, 0);
+                keyMin = restMin;
+                keyMax = restMax;
+                
+                for (int j = 0; j < keyframe->vertexCount; j++) {
+                    float v[3];
+                    Anim4dcSampleStored(&sampler, j, v);
+                    
+                    if (keyframe->moving) {
+                        const float *rest = keyframe->rest + keyframe->moving[j] * 3;
+                        v[0] += rest[0];
+                        v[1] += rest[1];
+                        v[2] += rest[2];
+                    }
+                    
+                    Vector3 position = { v[0], v[1], v[2] };
+                    keyMin = (j == 0 && !keyframe->moving) ? position : Vector3Min(keyMin, position);
+                    keyMax = (j == 0 && !keyframe->moving) ? position : Vector3Max(keyMax, position);
+                }
+                
+                for (int s = 0; s < keyframe->segmentCount; s++) {
+                    const float *m = keyframe->transforms + s * 12;
+                    for (uint32_t j = keyframe->segmentStarts[s]; j < keyframe->segmentStarts[s + 1]; j++) {
+                        const float *rest = keyframe->rest + keyframe->segmentVertices[j] * 3;
+                        Vector3 position = { m[0] * rest[0] + m[1] * rest[1] + m[2] * rest[2] + m[3],
+                                             m[4] * rest[0] + m[5] * rest[1] + m[6] * rest[2] + m[7],
+                                             m[8] * rest[0] + m[9] * rest[1] + m[10] * rest[2] + m[11] };
+                        keyMin = Vector3Min(keyMin, position);
+                        keyMax = Vector3Max(keyMax, position);
+                    }
+                }
+            } else if (keyframe->quantized) {
+                Vector3 extent = Vector3Scale(keyframe->scale, 32767.0f);
+                keyMin = Vector3Subtract(keyframe->offset, extent);
+                keyMax = Vector3Add(keyframe->offset, extent);
+            } else {
+                Anim4dcKeyframeBounds(keyframe, &keyMin, &keyMax);
+            }
+            
+            boundsMin = first ? keyMin : Vector3Min(boundsMin, keyMin);
+            boundsMax = first ? keyMax : Vector3Max(boundsMax, keyMax);
+            first = false;
+        }
+    }
+    
+    baked->boundsCenter = Vector3Scale(Vector3Add(boundsMin, boundsMax), 0.5f);
+    baked->boundsRadius = Vector3Length(Vector3Subtract(boundsMax, baked->boundsCenter));
+}
+
+// Allocate the interpolation buffer and start the first animation once keyframes are in place
+static bool Anim4dcFinishAnimationSetup(Anim4dcBakedModel *baked) {
+    baked->interpolationBuffer = (float*)malloc(baked->vertexCount * 3 * sizeof(float));
+    if (!baked->interpolationBuffer) {
+        printf("Anim4DC: ERROR - Failed to allocate interpolation buffer\n");
+        return false;
+    }
+    baked->outputVertices = baked->interpolationBuffer;
+    baked->outputStride = 3 * sizeof(float);
+    
+    // Set default animation
+    baked->currentAnimation = 0;
+    baked->currentTime = 0.0f;
+    baked->currentKeyframe = 0;
+    
+    Anim4dcComputeBounds(baked);
+    
+    // Calculate memory usage
+    baked->stats.memoryUsageKB = Anim4dcCalculateMemoryUsage(baked);
+    return true;
+}
+
+// Quantize a float box half extent into a per-axis INT16 dequantization scale
+static float Anim4dcQuantizationScale(float minValue, float maxValue) {
+    return (maxValue - minValue) * 0.5f / 32767.0f;
+}
+
+// Quantize one float keyframe against a box, returns the worst squared reconstruction error
+static float Anim4dcQuantizeKeyframe(Anim4dcVertexKeyframe *keyframe, short *quantized, Vector3 offset, Vector3 scale) {
+    float *vertices = keyframe->vertices;
+    float offsets[3] = { offset.x, offset.y, offset.z };
+    float scales[3] = { scale.x, scale.y, scale.z };
+    float worst = 0.0f;
+    
+    for (int i = 0; i < keyframe->vertexCount * 3; i += 3) {
+        float distance = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float q = (scales[c] > 0.0f) ? (vertices[i + c] - offsets[c]) / scales[c] : 0.0f;
+            q = (q < -32767.0f) ? -32767.0f : ((q > 32767.0f) ? 32767.0f : q);
+            quantized[i + c] = (short)lrintf(q);
+            
+            float error = offsets[c] + quantized[i + c] * scales[c] - vertices[i + c];
+            distance += error * error;
+        }
+        if (distance > worst) worst = distance;
+    }
+    
+    keyframe->quantized = quantized;
+    keyframe->offset = offset;
+    keyframe->scale = scale;
+    keyframe->vertices = NULL;
+    free(vertices);
+    
+    return worst;
+}
+
+// Convert an animation's float keyframes to INT16 storage, reports the worst reconstruction error
+static bool Anim4dcQuantizeAnimation(Anim4dcVertexAnimation *animation, Anim4dcStorageMode storage, float *quantizationError) {
+    Vector3 animMin = { 0 };
+    Vector3 animMax = { 0 };
+    
+    // Bounding box of the whole animation, per keyframe boxes are taken right before quantizing
+    for (int k = 0; k < animation->keyframeCount; k++) {
+        Vector3 keyMin, keyMax;
+        Anim4dcKeyframeBounds(&animation->keyframes[k], &keyMin, &keyMax);
+        
+        animMin = (k == 0) ? keyMin : Vector3Min(animMin, keyMin);
+        animMax = (k == 0) ? keyMax : Vector3Max(animMax, keyMax);
+    }
+    
+    float worst = 0.0f;
+    for (int k = 0; k < animation->keyframeCount; k++) {
+        Vector3 boxMin = animMin;
+        Vector3 boxMax = animMax;
+        if (storage == ANIM4DC_STORAGE_INT16_KEYFRAME) Anim4dcKeyframeBounds(&animation->keyframes[k], &boxMin, &boxMax);
+        
+        Vector3 offset = Vector3Scale(Vector3Add(boxMin, boxMax), 0.5f);
+        Vector3 scale = {
+            Anim4dcQuantizationScale(boxMin.x, boxMax.x),
+            Anim4dcQuantizationScale(boxMin.y, boxMax.y),
+            Anim4dcQuantizationScale(boxMin.z, boxMax.z)
+        };
+        
+        int vertexCount = animation->keyframes[k].vertexCount;
+        short *quantized = (short*)malloc((vertexCount > 0 ? vertexCount : 1) * 3 * sizeof(short));
+        if (!quantized) {
+            printf("Anim4DC: ERROR - Failed to allocate quantized keyframe\n");
+            return false;
+        }
+        
+        float error = Anim4dcQuantizeKeyframe(&animation->keyframes[k], quantized, offset, scale);
+        if (error > worst) worst = error;
+    }
+    
+    *quantizationError = sqrtf(worst);
+    return true;
+}
+
+// Eigenvalues and eigenvectors of a symmetric size x size matrix by cyclic Jacobi rotations
+// The matrix diagonal ends up holding the eigenvalues, vectors receives the matching eigenvectors as columns
+static void Anim4dcJacobiEigen(double *matrix, double *vectors, int size) {
+    for (int i = 0; i < size * size; i++) vectors[i] = ((i / size) == (i % size)) ? 1.0 : 0.0;
+    
+    for (int sweep = 0; sweep < 64; sweep++) {
+        double off = 0.0;
+        double diagonal = 0.0;
+        for (int p = 0; p < size; p++) {
+            diagonal += matrix[p * size + p] * matrix[p * size + p];
+            for (int q = p + 1; q < size; q++) off += matrix[p * size + q] * matrix[p * size + q];
+        }
+        if (off <= diagonal * 1e-24) break;
+        
+        for (int p = 0; p < size; p++) {
+            for (int q = p + 1; q < size; q++) {
+                double apq = matrix[p * size + q];
+                if (apq == 0.0) continue;
+                
+                // Rotation angle that zeroes the (p, q) entry
+                double theta = (matrix[q * size + q] - matrix[p * size + p]) / (2.0 * apq);
+                double t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                
+                for (int k = 0; k < size; k++) {
+                    double akp = matrix[k * size + p], akq = matrix[k * size + q];
+                    matrix[k * size + p] = c * akp - s * akq;
+                    matrix[k * size + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < size; k++) {
+                    double apk = matrix[p * size + k], aqk = matrix[q * size + k];
+                    matrix[p * size + k] = c * apk - s * aqk;
+                    matrix[q * size + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < size; k++) {
+                    double vkp = vectors[k * size + p], vkq = vectors[k * size + q];
+                    vectors[k * size + p] = c * vkp - s * vkq;
+                    vectors[k * size + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Worst per-vertex length of a set of residual keyframes
+static float Anim4dcResidualError(const float *residuals, int keyframeCount, int vertexCount) {
+    float worst = 0.0f;
+    
+    for (int i = 0; i < keyframeCount * vertexCount * 3; i += 3) {
+        float distance = residuals[i] * residuals[i] + residuals[i + 1] * residuals[i + 1] + residuals[i + 2] * residuals[i + 2];
+        if (distance > worst) worst = distance;
+    }
+    
+    return sqrtf(worst);
+}
+
+// Size of one keyframe's vertex data for a storage mode
+static int Anim4dcKeyframeDataSize(Anim4dcStorageMode storage, int vertexCount) {
+    return vertexCount * 3 * ((storage == ANIM4DC_STORAGE_FLOAT) ? sizeof(float) : sizeof(short));
+}
+
+// Bytes of a basis compressed animation's mean and basis shapes
+static int Anim4dcBasisDataSize(int basisCount, int vertexCount) {
+    return (basisCount + 1) * vertexCount * 3 * sizeof(float);
+}
+
+// Compress an animation's float keyframes (positions or sparse deltas) into a mean shape plus the
+// principal basis shapes and per-keyframe weights, keeping the fewest shapes whose reconstruction stays
+// within maxError of every keyframe. Animations it would not make smaller stay as they are
+// Shapes come from the eigenvectors of the keyframes' Gram matrix, so the work scales with keyframes
+// squared rather than vertices squared
+static bool Anim4dcCompressAnimationBasis(Anim4dcVertexAnimation *animation, Anim4dcStorageMode storage, float maxError, Anim4dcBakeReport *report) {
+    int keyframeCount = animation->keyframeCount;
+    int vertexCount = animation->keyframes[0].vertexCount;
+    int size = vertexCount * 3;
+    int maxShapes = (keyframeCount - 1 < ANIM4DC_MAX_BASIS_SHAPES) ? keyframeCount - 1 : ANIM4DC_MAX_BASIS_SHAPES;
+    
+    float *basis = (float*)malloc((maxShapes + 1) * (size > 0 ? size : 1) * sizeof(float));
+    float *coefficients = (float*)calloc(keyframeCount * (maxShapes > 0 ? maxShapes : 1), sizeof(float));
+    float *residuals = (float*)malloc(keyframeCount * (size > 0 ? size : 1) * sizeof(float));
+    double *gram = (double*)calloc(keyframeCount * keyframeCount, sizeof(double));
+    double *vectors = (double*)malloc(keyframeCount * keyframeCount * sizeof(double));
+    int *order = (int*)malloc(keyframeCount * sizeof(int));
+    if (!basis || !coefficients || !residuals || !gram || !vectors || !order) {
+        printf("Anim4DC: ERROR - Failed to allocate basis compression buffers\n");
+        free(basis);
+        free(coefficients);
+        free(residuals);
+        free(gram);
+        free(vectors);
+        free(order);
+        return false;
+    }
+    
+    // Mean shape, residuals start as the keyframes around it
+    float *mean = basis;
+    for (int i = 0; i < size; i++) {
+        double sum = 0.0;
+        for (int k = 0; k < keyframeCount; k++) sum += animation->keyframes[k].vertices[i];
+        mean[i] = (float)(sum / keyframeCount);
+    }
+    for (int k = 0; k < keyframeCount; k++) {
+        for (int i = 0; i < size; i++) residuals[k * size + i] = animation->keyframes[k].vertices[i] - mean[i];
+    }
+    
+    for (int a = 0; a < keyframeCount; a++) {
+        for (int b = a; b < keyframeCount; b++) {
+            double dot = 0.0;
+            for (int i = 0; i < size; i++) dot += (double)residuals[a * size + i] * residuals[b * size + i];
+            gram[a * keyframeCount + b] = gram[b * keyframeCount + a] = dot;
+        }
+    }
+    Anim4dcJacobiEigen(gram, vectors, keyframeCount);
+    
+    // Strongest shapes first
+    for (int k = 0; k < keyframeCount; k++) order[k] = k;
+    for (int k = 1; k < keyframeCount; k++) {
+        int current = order[k];
+        int j = k;
+        for (; j > 0 && gram[order[j - 1] * (keyframeCount + 1)] < gram[current * (keyframeCount + 1)]; j--) order[j] = order[j - 1];
+        order[j] = current;
+    }
+    
+    // Add shapes until every keyframe is reconstructed within maxError, each weight is the keyframe's
+    // projection on the stored (float) shape so rounding does not pile up
+    int basisCount = 0;
+    float error = Anim4dcResidualError(residuals, keyframeCount, vertexCount);
+    while (error > maxError && basisCount < maxShapes) {
+        double eigenvalue = gram[order[basisCount] * (keyframeCount + 1)];
+        if (eigenvalue <= 0.0) break;
+        
+        float *shape = basis + (basisCount + 1) * size;
+        double norm = 1.0 / sqrt(eigenvalue);
+        for (int i = 0; i < size; i++) {
+            double sum = 0.0;
+            for (int k = 0; k < keyframeCount; k++) sum += vectors[k * keyframeCount + order[basisCount]] * (animation->keyframes[k].vertices[i] - mean[i]);
+            shape[i] = (float)(sum * norm);
+        }
+        
+        for (int k = 0; k < keyframeCount; k++) {
+            float *residual = residuals + k * size;
+            double weight = 0.0;
+            for (int i = 0; i < size; i++) weight += (double)residual[i] * shape[i];
+            
+            coefficients[k * maxShapes + basisCount] = (float)weight;
+            for (int i = 0; i < size; i++) residual[i] -= (float)weight * shape[i];
+        }
+        
+        basisCount++;
+        error = Anim4dcResidualError(residuals, keyframeCount, vertexCount);
+    }
+    
+    free(residuals);
+    free(gram);
+    free(vectors);
+    free(order);
+    
+    int basisBytes = Anim4dcBasisDataSize(basisCount, vertexCount) + keyframeCount * basisCount * sizeof(float);
+    int keyframeBytes = keyframeCount * Anim4dcKeyframeDataSize(storage, vertexCount);
+    if (error > maxError || basisBytes >= keyframeBytes) {
+        printf("Anim4DC: %s keeps its keyframes (%d basis shapes reach error %.4f in %d of %d bytes)\n", 
+               animation->name, basisCount, error, basisBytes, keyframeBytes);
+        free(basis);
+        free(coefficients);
+        return true;
+    }
+    
+    // Pack the weights basisCount per keyframe and drop the keyframe positions
+    for (int k = 0; k < keyframeCount; k++) {
+        memmove(coefficients + k * basisCount, coefficients + k * maxShapes, basisCount * sizeof(float));
+    }
+    animation->basis = basis;
+    animation->coefficients = coefficients;
+    animation->basisCount = basisCount;
+    for (int k = 0; k < keyframeCount; k++) {
+        Anim4dcVertexKeyframe *keyframe = &animation->keyframes[k];
+        free(keyframe->vertices);
+        keyframe->vertices = NULL;
+        keyframe->basis = basis;
+        keyframe->coefficients = coefficients + k * basisCount;
+        keyframe->basisCount = basisCount;
+    }
+    
+    if (report) {
+        report->basisShapes = basisCount;
+        report->basisError = error;
+    }
+    
+    printf("Anim4DC: Compressed %s to %d basis shapes (max error %.4f, %d -> %d bytes)\n", 
+           animation->name, basisCount, error, keyframeBytes, basisBytes);
+    return true;
+}
+
+// Position of a staged float keyframe's vertex, stored at entry j (its moving list index in a sparse keyframe)
+static void Anim4dcStagedPosition(const Anim4dcVertexKeyframe *keyframe, int j, int vertex, float *output) {
+    const float *stored = keyframe->vertices + j * 3;
+    for (int c = 0; c < 3; c++) output[c] = keyframe->moving ? keyframe->rest[vertex * 3 + c] + stored[c] : stored[c];
+}
+
+// Least squares 3x4 transforms taking a segment's rest positions to its positions in each keyframe
+// members index the animation's stored vertices, vertices[members[i]] is the baked vertex
+static void Anim4dcFitSegment(const Anim4dcVertexAnimation *animation, const float *restPose, const uint32_t *vertices, 
+                              const int *members, int memberCount, float *transforms) {
+    // Rest centroid and covariance, the same for every keyframe
+    double restCenter[3] = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < memberCount; i++) {
+        for (int c = 0; c < 3; c++) restCenter[c] += restPose[vertices[members[i]] * 3 + c];
+    }
+    for (int c = 0; c < 3; c++) restCenter[c] /= memberCount;
+    
+    double covariance[9] = { 0.0 };
+    for (int i = 0; i < memberCount; i++) {
+        const float *rest = restPose + vertices[members[i]] * 3;
+        double p[3] = { rest[0] - restCenter[0], rest[1] - restCenter[1], rest[2] - restCenter[2] };
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) covariance[r * 3 + c] += p[r] * p[c];
+        }
+    }
+    
+    // Flat or thin segments leave the covariance singular, a small ridge keeps their off-plane axis at zero
+    double ridge = (covariance[0] + covariance[4] + covariance[8]) * 1e-9 + 1e-12;
+    for (int c = 0; c < 3; c++) covariance[c * 4] += ridge;
+    
+    double inverse[9];
+    inverse[0] = covariance[4] * covariance[8] - covariance[5] * covariance[7];
+    inverse[1] = covariance[2] * covariance[7] - covariance[1] * covariance[8];
+    inverse[2] = covariance[1] * covariance[5] - covariance[2] * covariance[4];
+    inverse[3] = covariance[5] * covariance[6] - covariance[3] * covariance[8];
+    inverse[4] = covariance[0] * covariance[8] - covariance[2] * covariance[6];
+    inverse[5] = covariance[2] * covariance[3] - covariance[0] * covariance[5];
+    inverse[6] = covariance[3] * covariance[7] - covariance[4] * covariance[6];
+    inverse[7] = covariance[1] * covariance[6] - covariance[0] * covariance[7];
+    inverse[8] = covariance[0] * covariance[4] - covariance[1] * covariance[3];
+    double determinant = covariance[0] * inverse[0] + covariance[1] * inverse[3] + covariance[2] * inverse[6];
+    for (int i = 0; i < 9; i++) inverse[i] /= determinant;
+    
+    for (int k = 0; k < animation->keyframeCount; k++) {
+        const Anim4dcVertexKeyframe *keyframe = &animation->keyframes[k];
+        double center[3] = { 0.0, 0.0, 0.0 };
+        double cross[9] = { 0.0 };
+        
+        for (int i = 0; i < memberCount; i++) {
+            float q[3];
+            Anim4dcStagedPosition(keyframe, members[i], vertices[members[i]], q);
+            for (int c = 0; c < 3; c++) center[c] += q[c];
+        }
+        for (int c = 0; c < 3; c++) center[c] /= memberCount;
+        
+        for (int i = 0; i < memberCount; i++) {
+            float q[3];
+            const float *rest = restPose + vertices[members[i]] * 3;
+            Anim4dcStagedPosition(keyframe, members[i], vertices[members[i]], q);
+            double p[3] = { rest[0] - restCenter[0], rest[1] - restCenter[1], rest[2] - restCenter[2] };
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) cross[r * 3 + c] += (q[r] - center[r]) * p[c];
+            }
+        }
+        
+        // Linear part = cross covariance * inverse rest covariance, translation maps the centroids
+        float *m = transforms + k * 12;
+        for (int r = 0; r < 3; r++) {
+            double translation = center[r];
+            for (int c = 0; c < 3; c++) {
+                double linear = cross[r * 3] * inverse[c] + cross[r * 3 + 1] * inverse[3 + c] + cross[r * 3 + 2] * inverse[6 + c];
+                m[r * 4 + c] = (float)linear;
+                translation -= linear * restCenter[c];
+            }
+            m[r * 4 + 3] = (float)translation;
+        }
+    }
+}
+
+// Worst distance over the keyframes between each member's position and its rest position through the transforms
+static void Anim4dcSegmentErrors(const Anim4dcVertexAnimation *animation, const float *restPose, const uint32_t *vertices, 
+                                 const int *members, int memberCount, const float *transforms, float *errors) {
+    for (int i = 0; i < memberCount; i++) {
+        const float *rest = restPose + vertices[members[i]] * 3;
+        float worst = 0.0f;
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            const float *m = transforms + k * 12;
+            float q[3];
+            Anim4dcStagedPosition(&animation->keyframes[k], members[i], vertices[members[i]], q);
+            
+            float dx = m[0] * rest[0] + m[1] * rest[1] + m[2] * rest[2] + m[3] - q[0];
+            float dy = m[4] * rest[0] + m[5] * rest[1] + m[6] * rest[2] + m[7] - q[1];
+            float dz = m[8] * rest[0] + m[9] * rest[1] + m[10] * rest[2] + m[11] - q[2];
+            float distance = dx * dx + dy * dy + dz * dz;
+            if (distance > worst) worst = distance;
+        }
+        
+        errors[i] = sqrtf(worst);
+    }
+}
+
+// Move vertices that follow their dominant bone rigidly out of each animation's keyframes: the stored vertices
+// weighted (almost) fully to a bone get least squares 3x4 transforms of the rest pose per keyframe, those the
+// transforms miss by more than maxError drop out and the rest is refitted. Every stored vertex dominated by the bone
+// that the transforms then reproduce within maxError joins the segment (kept if at least ANIM4DC_RIGID_MIN_VERTICES)
+// and the animation goes sparse with the deforming vertices as its moving ones (static ones stay at rest)
+// Runs on the staged float keyframes after sparse encoding, animations it would not make smaller stay as they are
+static bool Anim4dcEncodeRigidSegments(Anim4dcBakedModel *baked, Model model, float maxError, Anim4dcStorageMode storage, Anim4dcBakeReport *reports) {
+    int vertexCount = baked->vertexCount;
+    
+    float *restPose = baked->restPose;
+    if (!restPose && !Anim4dcBuildRestPose(baked, model, &restPose)) return false;
+    if (!restPose) return true;
+    
+    unsigned char *bones = (unsigned char*)malloc(vertexCount);
+    unsigned char *fitted = (unsigned char*)malloc(vertexCount);
+    uint32_t *vertices = (uint32_t*)malloc(vertexCount * sizeof(uint32_t));
+    int *members = (int*)malloc(vertexCount * sizeof(int));
+    int *segments = (int*)malloc(vertexCount * sizeof(int));
+    float *errors = (float*)malloc(vertexCount * sizeof(float));
+    bool success = (bones && fitted && vertices && members && segments && errors);
+    
+    // Dominant bone of each baked vertex and whether it follows that bone alone
+    for (int r = 0; r < baked->meshCount && success; r++) {
+        const Anim4dcMeshRange *range = &baked->meshes[r];
+        const Mesh *mesh = &model.meshes[range->meshIndex];
+        
+        for (int i = 0; i < range->vertexCount; i++) {
+            int strongest = 0;
+            for (int j = 1; j < 4; j++) {
+                if (mesh->boneWeights[i * 4 + j] > mesh->boneWeights[i * 4 + strongest]) strongest = j;
+            }
+            bones[range->vertexOffset + i] = mesh->boneIds[i * 4 + strongest];
+            fitted[range->vertexOffset + i] = (mesh->boneWeights[i * 4 + strongest] >= ANIM4DC_RIGID_MIN_WEIGHT);
+        }
+    }
+    
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        Anim4dcVertexAnimation *animation = &baked->animations[a];
+        int keyframeCount = animation->keyframeCount;
+        int storedCount = (keyframeCount > 0) ? animation->keyframes[0].vertexCount : 0;
+        int maxSegments = storedCount / ANIM4DC_RIGID_MIN_VERTICES;
+        if (maxSegments > 256) maxSegments = 256;
+        if (maxSegments == 0) continue;
+        
+        for (int j = 0; j < storedCount; j++) {
+            vertices[j] = animation->movingVertices ? animation->movingVertices[j] : (uint32_t)j;
+            segments[j] = -1;
+        }
+        
+        // Each segment's transforms, segment by segment until the count is known
+        float *staged = (float*)malloc(maxSegments * keyframeCount * 12 * sizeof(float));
+        if (!staged) {
+            success = false;
+            break;
+        }
+        
+        int segmentCount = 0;
+        int rigidCount = 0;
+        float worstError = 0.0f;
+        for (int bone = 0; bone < 256 && segmentCount < maxSegments; bone++) {
+            float *transforms = staged + segmentCount * keyframeCount * 12;
+            int memberCount = 0;
+            for (int j = 0; j < storedCount; j++) {
+                if (bones[vertices[j]] == bone && fitted[vertices[j]]) members[memberCount++] = j;
+            }
+            
+            // Kept members always fit the last transforms, refitting only tightens them
+            for (int pass = 0; pass < 3 && memberCount >= ANIM4DC_RIGID_MIN_VERTICES; pass++) {
+                Anim4dcFitSegment(animation, restPose, vertices, members, memberCount, transforms);
+                Anim4dcSegmentErrors(animation, restPose, vertices, members, memberCount, transforms, errors);
+                
+                int kept = 0;
+                for (int i = 0; i < memberCount; i++) {
+                    if (errors[i] <= maxError) members[kept++] = members[i];
+                }
+                bool converged = (kept == memberCount);
+                memberCount = kept;
+                if (converged) break;
+            }
+            if (memberCount < ANIM4DC_RIGID_MIN_VERTICES) continue;
+            
+            // Blended vertices the bone's transforms still reproduce join its segment
+            memberCount = 0;
+            for (int j = 0; j < storedCount; j++) {
+                if (bones[vertices[j]] == bone) members[memberCount++] = j;
+            }
+            Anim4dcSegmentErrors(animation, restPose, vertices, members, memberCount, transforms, errors);
+            
+            int kept = 0;
+            float segmentError = 0.0f;
+            for (int i = 0; i < memberCount; i++) {
+                if (errors[i] > maxError) continue;
+                members[kept++] = members[i];
+                if (errors[i] > segmentError) segmentError = errors[i];
+            }
+            if (kept < ANIM4DC_RIGID_MIN_VERTICES) continue;
+            
+            for (int i = 0; i < kept; i++) segments[members[i]] = segmentCount;
+            if (segmentError > worstError) worstError = segmentError;
+            rigidCount += kept;
+            segmentCount++;
+        }
+        
+        int movingCount = storedCount - rigidCount;
+        int keyframeBytes = keyframeCount * Anim4dcKeyframeDataSize(storage, storedCount);
+        int rigidBytes = keyframeCount * (Anim4dcKeyframeDataSize(storage, movingCount) + segmentCount * 12 * (int)sizeof(float)) + 
+                         (segmentCount + 1 + rigidCount) * (int)sizeof(uint32_t);
+        if (segmentCount == 0 || rigidBytes >= keyframeBytes) {
+            if (segmentCount > 0) {
+                printf("Anim4DC: %s keeps its keyframes (%d rigid segments take %d of %d bytes)\n", 
+                       animation->name, segmentCount, rigidBytes, keyframeBytes);
+            }
+            free(staged);
+            continue;
+        }
+        
+        // The staged model owns the rest pose as soon as a keyframe points at it
+        baked->restPose = restPose;
+        
+        uint32_t *moving = (uint32_t*)malloc((movingCount > 0 ? movingCount : 1) * sizeof(uint32_t));
+        animation->segmentStarts = (uint32_t*)malloc((segmentCount + 1 + rigidCount) * sizeof(uint32_t));
+        animation->transforms = (float*)malloc(keyframeCount * segmentCount * 12 * sizeof(float));
+        animation->segmentCount = segmentCount;
+        if (!moving || !animation->segmentStarts || !animation->transforms) {
+            free(moving);
+            free(staged);
+            success = false;
+            break;
+        }
+        
+        int count = 0;
+        for (int j = 0; j < storedCount; j++) {
+            if (segments[j] < 0) moving[count++] = vertices[j];
+        }
+        count = 0;
+        animation->segmentVertices = animation->segmentStarts + segmentCount + 1;
+        for (int segment = 0; segment < segmentCount; segment++) {
+            animation->segmentStarts[segment] = count;
+            for (int j = 0; j < storedCount; j++) {
+                if (segments[j] == segment) animation->segmentVertices[count++] = vertices[j];
+            }
+            for (int k = 0; k < keyframeCount; k++) {
+                memcpy(animation->transforms + (k * segmentCount + segment) * 12, staged + (segment * keyframeCount + k) * 12, 12 * sizeof(float));
+            }
+        }
+        animation->segmentStarts[segmentCount] = count;
+        free(staged);
+        
+        // Deforming vertices keep their keyframes, as deltas from the rest pose
+        for (int k = 0; k < keyframeCount && success; k++) {
+            Anim4dcVertexKeyframe *keyframe = &animation->keyframes[k];
+            float *deltas = (float*)malloc((movingCount > 0 ? movingCount : 1) * 3 * sizeof(float));
+            if (!deltas) {
+                success = false;
+                break;
+            }
+            
+            int m = 0;
+            for (int j = 0; j < storedCount; j++) {
+                if (segments[j] >= 0) continue;
+                
+                float position[3];
+                Anim4dcStagedPosition(keyframe, j, vertices[j], position);
+                for (int c = 0; c < 3; c++) deltas[m * 3 + c] = position[c] - restPose[vertices[j] * 3 + c];
+                m++;
+            }
+            
+            free(keyframe->vertices);
+            keyframe->vertices = deltas;
+            keyframe->vertexCount = movingCount;
+            keyframe->rest = restPose;
+            keyframe->moving = moving;
+            keyframe->transforms = animation->transforms + k * segmentCount * 12;
+            keyframe->segmentVertices = animation->segmentVertices;
+            keyframe->segmentStarts = animation->segmentStarts;
+            keyframe->segmentCount = segmentCount;
+        }
+        
+        free(animation->movingVertices);
+        animation->movingVertices = moving;
+        animation->movingCount = movingCount;
+        if (!success) break;
+        
+        if (reports) {
+            reports[a].movingVertices = movingCount;
+            reports[a].rigidSegments = segmentCount;
+            reports[a].rigidVertices = rigidCount;
+            reports[a].rigidError = worstError;
+        }
+        printf("Anim4DC: %s moves %d vertices in %d rigid segments (max error %.4f), %d deform (%d -> %d bytes)\n", 
+               animation->name, rigidCount, segmentCount, worstError, movingCount, keyframeBytes, rigidBytes);
+    }
+    
+    free(bones);
+    free(fitted);
+    free(vertices);
+    free(members);
+    free(segments);
+    free(errors);
+    if (restPose != baked->restPose) free(restPose);
+    
+    if (!success) printf("Anim4DC: ERROR - Failed to allocate rigid segments\n");
+    return success;
+}
+
+// Bytes of a keyframe's own vertex block, basis compressed keyframes keep theirs empty
+static int Anim4dcKeyframeBytes(Anim4dcStorageMode storage, const Anim4dcVertexKeyframe *keyframe) {
+    return keyframe->basis ? 0 : Anim4dcKeyframeDataSize(storage, keyframe->vertexCount);
+}
+
+// Bytes of a rigid animation's segment starts and vertices
+static int Anim4dcSegmentListSize(const Anim4dcVertexAnimation *animation) {
+    if (!animation->segmentStarts) return 0;
+    
+    return (animation->segmentCount + 1 + animation->segmentStarts[animation->segmentCount]) * sizeof(uint32_t);
+}
+
+// Bytes of an animation's keyframe data as stored: vertex blocks, or basis shapes and weights, plus
+// the segment transforms of a rigid animation
+static int Anim4dcAnimationDataSize(Anim4dcStorageMode storage, const Anim4dcVertexAnimation *animation) {
+    if (animation->keyframeCount <= 0) return 0;
+    
+    int vertexCount = animation->keyframes[0].vertexCount;
+    int transformBytes = animation->keyframeCount * animation->segmentCount * 12 * sizeof(float);
+    if (animation->basis) {
+        return Anim4dcBasisDataSize(animation->basisCount, vertexCount) + animation->keyframeCount * animation->basisCount * sizeof(float) + 
+               transformBytes;
+    }
+    
+    return animation->keyframeCount * Anim4dcKeyframeDataSize(storage, vertexCount) + transformBytes;
+}
+
+// Round a file offset up to the keyframe block alignment
+static uint32_t Anim4dcAlignOffset(uint32_t offset) {
+    return (offset + ANIM4DC_BAKED_ALIGNMENT - 1) & ~(uint32_t)(ANIM4DC_BAKED_ALIGNMENT - 1);
+}
+
+//----------------------------------------------------------------------------------
+// Model Arena
+//----------------------------------------------------------------------------------
+// [animations][keyframes][pad][payload], the base is ANIM4DC_BAKED_ALIGNMENT aligned and the
+// payload is either the keyframe vertex blocks of a bake or the image of a loaded .a4d file
+
+// Bytes taken by the animation and keyframe descriptors, padded so the payload stays aligned
+// (keyframeCount covers the full resolution keyframes and those of every mesh variant)
+static uint32_t Anim4dcArenaDescriptorSize(uint32_t animationCount, uint32_t keyframeCount) {
+    return Anim4dcAlignOffset(animationCount * sizeof(Anim4dcVertexAnimation) + keyframeCount * sizeof(Anim4dcVertexKeyframe));
+}
+
+// Number of mesh variants a baked model has
+static int Anim4dcCountMeshVariants(const Anim4dcBakedModel *baked) {
+    int count = 0;
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        if (baked->variants[v].vertexCount > 0) count++;
+    }
+    
+    return count;
+}
+
+// Bytes of a mesh variant's data, laid out the same in the arena payload and the file:
+// aligned keyframe blocks, then source vertices and indices each padded to the alignment
+static uint32_t Anim4dcVariantDataSize(Anim4dcStorageMode storage, const Anim4dcMeshVariant *variant, uint32_t keyframeCount) {
+    if (variant->vertexCount <= 0) return 0;
+    
+    return keyframeCount * Anim4dcAlignOffset(Anim4dcKeyframeDataSize(storage, variant->vertexCount)) +
+           Anim4dcAlignOffset(variant->vertexCount * sizeof(uint32_t)) + Anim4dcAlignOffset(variant->indexCount * sizeof(unsigned short));
+}
+
+// Bytes of the aligned keyframe vertex blocks of the full resolution meshes or a mesh variant
+static uint32_t Anim4dcKeyframeBlocksSize(const Anim4dcBakedModel *baked, int meshVariant) {
+    uint32_t size = 0;
+    for (int a = 0; a < baked->animationCount; a++) {
+        const Anim4dcVertexKeyframe *keyframes = Anim4dcGetVariantKeyframes(baked, meshVariant, a);
+        for (int k = 0; k < baked->animations[a].keyframeCount; k++) {
+            size += Anim4dcAlignOffset(Anim4dcKeyframeBytes(baked->storage, &keyframes[k]));
+        }
+    }
+    
+    return size;
+}
+
+// Bytes of the rest pose and the moving vertex lists of sparse animations, each padded to the alignment
+static uint32_t Anim4dcSparseDataSize(const Anim4dcBakedModel *baked) {
+    if (!baked->restPose) return 0;
+    
+    uint32_t size = Anim4dcAlignOffset(baked->vertexCount * 3 * sizeof(float));
+    for (int a = 0; a < baked->animationCount; a++) {
+        if (baked->animations[a].movingVertices) size += Anim4dcAlignOffset(baked->animations[a].movingCount * sizeof(uint32_t));
+    }
+    
+    return size;
+}
+
+// Bytes of the basis shapes and weights of basis compressed animations, each padded to the alignment
+static uint32_t Anim4dcBasisBlocksSize(const Anim4dcBakedModel *baked) {
+    uint32_t size = 0;
+    for (int a = 0; a < baked->animationCount; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->basis) continue;
+        
+        size += Anim4dcAlignOffset(Anim4dcBasisDataSize(animation->basisCount, animation->keyframes[0].vertexCount)) +
+                Anim4dcAlignOffset(animation->keyframeCount * animation->basisCount * sizeof(float));
+    }
+    
+    return size;
+}
+
+// Bytes of the segment lists and transforms of rigid animations, each padded to the alignment
+static uint32_t Anim4dcRigidBlocksSize(const Anim4dcBakedModel *baked) {
+    uint32_t size = 0;
+    for (int a = 0; a < baked->animationCount; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->segmentStarts) continue;
+        
+        size += Anim4dcAlignOffset(Anim4dcSegmentListSize(animation)) + 
+                Anim4dcAlignOffset(animation->keyframeCount * animation->segmentCount * 12 * sizeof(float));
+    }
+    
+    return size;
+}
+
+// Aligned start of an arena allocation
+static unsigned char *Anim4dcArenaBase(void *arena) {
+    return (unsigned char*)(((uintptr_t)arena + ANIM4DC_BAKED_ALIGNMENT - 1) & ~(uintptr_t)(ANIM4DC_BAKED_ALIGNMENT - 1));
+}
+
+// Copy a staged keyframe's vertex data into an arena block, zero padding the rest of the block
+static void Anim4dcPackKeyframe(Anim4dcVertexKeyframe *packed, const Anim4dcVertexKeyframe *staged, unsigned char *block, uint32_t vertexBytes, uint32_t blockSize) {
+    *packed = *staged;
+    
+    if (staged->quantized) {
+        packed->quantized = (short*)memcpy(block, staged->quantized, vertexBytes);
+    } else if (staged->vertices) {
+        packed->vertices = (float*)memcpy(block, staged->vertices, vertexBytes);
+    }
+    memset(block + vertexBytes, 0, blockSize - vertexBytes);
+}
+
+// Move the staged bake into one arena sized exactly to its content, one keyframe block per cache line run
+// The rest pose, moving vertex lists, basis shapes and rigid segments follow the keyframe blocks, then the mesh variant
+// data; mesh variant keyframe descriptors follow the full resolution ones
+static bool Anim4dcPackArena(Anim4dcBakedModel *baked) {
+    uint32_t keyframeCount = 0;
+    for (int a = 0; a < baked->animationCount; a++) keyframeCount += baked->animations[a].keyframeCount;
+    
+    uint32_t variantSize = 0;
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) variantSize += Anim4dcVariantDataSize(baked->storage, &baked->variants[v], keyframeCount);
+    
+    uint32_t descriptorSize = Anim4dcArenaDescriptorSize(baked->animationCount, keyframeCount * (1 + Anim4dcCountMeshVariants(baked)));
+    int arenaSize = descriptorSize + Anim4dcKeyframeBlocksSize(baked, 0) + Anim4dcSparseDataSize(baked) + Anim4dcBasisBlocksSize(baked) + 
+                    Anim4dcRigidBlocksSize(baked) + variantSize + ANIM4DC_BAKED_ALIGNMENT - 1;
+    
+    void *arena = malloc(arenaSize);
+    if (!arena) {
+        printf("Anim4DC: ERROR - Failed to allocate %d byte model arena\n", arenaSize);
+        return false;
+    }
+    
+    unsigned char *base = Anim4dcArenaBase(arena);
+    Anim4dcVertexAnimation *animations = (Anim4dcVertexAnimation*)base;
+    Anim4dcVertexKeyframe *keyframes = (Anim4dcVertexKeyframe*)(animations + baked->animationCount);
+    unsigned char *block = base + descriptorSize;
+    
+    for (int a = 0; a < baked->animationCount; a++) {
+        animations[a] = baked->animations[a];
+        animations[a].keyframes = keyframes;
+        
+        for (int k = 0; k < animations[a].keyframeCount; k++) {
+            uint32_t vertexBytes = Anim4dcKeyframeBytes(baked->storage, &baked->animations[a].keyframes[k]);
+            Anim4dcPackKeyframe(&keyframes[k], &baked->animations[a].keyframes[k], block, vertexBytes, Anim4dcAlignOffset(vertexBytes));
+            block += Anim4dcAlignOffset(vertexBytes);
+        }
+        keyframes += animations[a].keyframeCount;
+    }
+    
+    // Sparse keyframes are pointed at the packed rest pose and their animation's packed moving list
+    float *restPose = NULL;
+    if (baked->restPose) {
+        restPose = (float*)memcpy(block, baked->restPose, baked->vertexCount * 3 * sizeof(float));
+        block += Anim4dcAlignOffset(baked->vertexCount * 3 * sizeof(float));
+    }
+    for (int a = 0; a < baked->animationCount; a++) {
+        if (!animations[a].movingVertices) continue;
+        
+        animations[a].movingVertices = (uint32_t*)memcpy(block, animations[a].movingVertices, animations[a].movingCount * sizeof(uint32_t));
+        block += Anim4dcAlignOffset(animations[a].movingCount * sizeof(uint32_t));
+        for (int k = 0; k < animations[a].keyframeCount; k++) {
+            animations[a].keyframes[k].rest = restPose;
+            animations[a].keyframes[k].moving = animations[a].movingVertices;
+        }
+    }
+    
+    // Basis compressed keyframes are pointed at the packed shapes and their own weights
+    for (int a = 0; a < baked->animationCount; a++) {
+        Anim4dcVertexAnimation *animation = &animations[a];
+        if (!animation->basis) continue;
+        
+        uint32_t basisBytes = Anim4dcBasisDataSize(animation->basisCount, animation->keyframes[0].vertexCount);
+        uint32_t coefficientBytes = animation->keyframeCount * animation->basisCount * sizeof(float);
+        animation->basis = (float*)memcpy(block, animation->basis, basisBytes);
+        block += Anim4dcAlignOffset(basisBytes);
+        animation->coefficients = (float*)memcpy(block, animation->coefficients, coefficientBytes);
+        block += Anim4dcAlignOffset(coefficientBytes);
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            animation->keyframes[k].basis = animation->basis;
+            animation->keyframes[k].coefficients = animation->coefficients + k * animation->basisCount;
+        }
+    }
+    
+    // Rigid keyframes are pointed at the packed segment lists and their own transforms
+    for (int a = 0; a < baked->animationCount; a++) {
+        Anim4dcVertexAnimation *animation = &animations[a];
+        if (!animation->segmentStarts) continue;
+        
+        uint32_t transformBytes = animation->keyframeCount * animation->segmentCount * 12 * sizeof(float);
+        uint32_t listBytes = Anim4dcSegmentListSize(animation);
+        animation->segmentStarts = (uint32_t*)memcpy(block, animation->segmentStarts, listBytes);
+        animation->segmentVertices = animation->segmentStarts + animation->segmentCount + 1;
+        block += Anim4dcAlignOffset(listBytes);
+        animation->transforms = (float*)memcpy(block, animation->transforms, transformBytes);
+        block += Anim4dcAlignOffset(transformBytes);
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            animation->keyframes[k].segmentStarts = animation->segmentStarts;
+            animation->keyframes[k].segmentVertices = animation->segmentVertices;
+            animation->keyframes[k].transforms = animation->transforms + k * animation->segmentCount * 12;
+        }
+    }
+    
+    Anim4dcMeshVariant variants[ANIM4DC_MAX_MESH_VARIANTS];
+    memcpy(variants, baked->variants, sizeof(variants));
+    
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        Anim4dcMeshVariant *variant = &variants[v];
+        if (variant->vertexCount <= 0) continue;
+        
+        uint32_t variantBytes = Anim4dcKeyframeDataSize(baked->storage, variant->vertexCount);
+        uint32_t variantBlockSize = Anim4dcAlignOffset(variantBytes);
+        for (uint32_t k = 0; k < keyframeCount; k++) {
+            Anim4dcPackKeyframe(&keyframes[k], &variant->keyframes[k], block, variantBytes, variantBlockSize);
+            block += variantBlockSize;
+        }
+        variant->keyframes = keyframes;
+        keyframes += keyframeCount;
+        
+        variant->sourceVertices = (uint32_t*)memcpy(block, variant->sourceVertices, variant->vertexCount * sizeof(uint32_t));
+        block += Anim4dcAlignOffset(variant->vertexCount * sizeof(uint32_t));
+        variant->indices = (unsigned short*)memcpy(block, variant->indices, variant->indexCount * sizeof(unsigned short));
+        block += Anim4dcAlignOffset(variant->indexCount * sizeof(unsigned short));
+    }
+    
+    Anim4dcFreeStagedAnimations(baked);
+    baked->animations = animations;
+    baked->restPose = restPose;
+    memcpy(baked->variants, variants, sizeof(variants));
+    baked->arena = arena;
+    baked->arenaSize = arenaSize;
+    return true;
+}
+
+// Check a baked file image (header, tables and block offsets) before anything points into it
+static bool Anim4dcValidateBaked(const unsigned char *bytes, int dataSize) {
+    if (dataSize < (int)sizeof(Anim4dcBakedHeader)) {
+        printf("Anim4DC: ERROR - Invalid baked animation data\n");
+        return false;
+    }
+    
+    const Anim4dcBakedHeader *header = (const Anim4dcBakedHeader*)bytes;
+    
+    if (memcmp(header->magic, ANIM4DC_BAKED_MAGIC, 4) != 0 || header->version != ANIM4DC_BAKED_VERSION) {
+        printf("Anim4DC: ERROR - Unsupported baked file (version %u, expected %d)\n", 
+               (unsigned)header->version, ANIM4DC_BAKED_VERSION);
+        return false;
+    }
+    
+    if (header->fileSize > (uint32_t)dataSize || header->storage > ANIM4DC_STORAGE_INT16_KEYFRAME || header->animationCount == 0 || 
+        header->animationCount > header->fileSize / sizeof(Anim4dcBakedAnimation) || header->vertexCount == 0 ||
+        header->keyframeCount > header->fileSize / sizeof(Anim4dcBakedKeyframe) ||
+        header->vertexCount > header->fileSize / (3 * sizeof(short)) ||
+        header->meshCount == 0 || header->meshCount > ANIM4DC_MAX_MESHES ||
+        header->meshOffset + header->meshCount * sizeof(Anim4dcBakedMesh) > header->fileSize ||
+        header->animationOffset + header->animationCount * sizeof(Anim4dcBakedAnimation) > header->fileSize ||
+        header->keyframeOffset + header->keyframeCount * sizeof(Anim4dcBakedKeyframe) > header->fileSize ||
+        header->variantCount >= ANIM4DC_MAX_MESH_VARIANTS ||
+        header->variantOffset + header->variantCount * sizeof(Anim4dcBakedVariant) > header->fileSize ||
+        (header->restOffset != 0 && ((header->restOffset & 3) != 0 || 
+                                     header->restOffset + header->vertexCount * 3 * sizeof(float) > header->fileSize))) {
+        printf("Anim4DC: ERROR - Corrupt baked file header\n");
+        return false;
+    }
+    
+    const Anim4dcBakedMesh *meshTable = (const Anim4dcBakedMesh*)(bytes + header->meshOffset);
+    const Anim4dcBakedAnimation *animTable = (const Anim4dcBakedAnimation*)(bytes + header->animationOffset);
+    const Anim4dcBakedKeyframe *keyframeTable = (const Anim4dcBakedKeyframe*)(bytes + header->keyframeOffset);
+    
+    uint32_t meshVertices = 0;
+    for (uint32_t r = 0; r < header->meshCount; r++) {
+        if (meshTable[r].vertexOffset != meshVertices || meshTable[r].vertexCount > header->vertexCount - meshVertices ||
+            meshTable[r].sourceVertexCount < meshTable[r].vertexCount) {
+            printf("Anim4DC: ERROR - Corrupt mesh table entry %u\n", (unsigned)r);
+            return false;
+        }
+        meshVertices += meshTable[r].vertexCount;
+    }
+    if (meshVertices != header->vertexCount) {
+        printf("Anim4DC: ERROR - Mesh table does not cover the keyframe vertices\n");
+        return false;
+    }
+    for (uint32_t a = 0; a < header->animationCount; a++) {
+        const Anim4dcBakedAnimation *animation = &animTable[a];
+        bool sparse = (animation->movingOffset != 0);
+        bool valid = (animation->firstKeyframe <= header->keyframeCount && 
+                      animation->keyframeCount <= header->keyframeCount - animation->firstKeyframe);
+        
+        // Moving vertex lists need a rest pose and must rise strictly inside the keyframe vertices
+        if (valid && sparse) {
+            valid = (header->restOffset != 0 && (animation->movingOffset & 3) == 0 && animation->movingCount <= header->vertexCount &&
+                     animation->movingOffset + animation->movingCount * sizeof(uint32_t) <= header->fileSize);
+            
+            const uint32_t *moving = (const uint32_t*)(bytes + animation->movingOffset);
+            for (uint32_t j = 0; j < animation->movingCount && valid; j++) {
+                valid = (moving[j] < header->vertexCount && (j == 0 || moving[j] > moving[j - 1]));
+            }
+        }
+        
+        // Basis shapes cover the stored vertices, weights every keyframe
+        uint32_t storedVertices = sparse ? animation->movingCount : header->vertexCount;
+        bool compressed = (animation->basisOffset != 0);
+        if (valid && compressed) {
+            valid = (animation->basisCount <= ANIM4DC_MAX_BASIS_SHAPES && (animation->basisOffset & 3) == 0 && 
+                     (animation->coefficientOffset & 3) == 0 && animation->keyframeCount > 0 &&
+                     animation->basisOffset + (uint32_t)Anim4dcBasisDataSize(animation->basisCount, storedVertices) <= header->fileSize &&
+                     animation->coefficientOffset + animation->keyframeCount * animation->basisCount * sizeof(float) <= header->fileSize);
+        }
+        
+        // Rigid animations are sparse, segment starts rise to the segment vertices' end, vertices inside each segment
+        // rise and none is a moving one
+        if (valid && animation->segmentOffset != 0) {
+            valid = (sparse && animation->segmentCount > 0 && animation->segmentCount <= header->vertexCount &&
+                     (animation->segmentOffset & 3) == 0 && (animation->transformOffset & 3) == 0 &&
+                     animation->segmentOffset + (animation->segmentCount + 1) * sizeof(uint32_t) <= header->fileSize &&
+                     animation->keyframeCount <= header->fileSize / (12 * sizeof(float)) / animation->segmentCount &&
+                     animation->transformOffset + animation->keyframeCount * animation->segmentCount * 12 * sizeof(float) <= header->fileSize);
+            
+            const uint32_t *starts = (const uint32_t*)(bytes + animation->segmentOffset);
+            const uint32_t *segmentVertices = starts + animation->segmentCount + 1;
+            const uint32_t *moving = (const uint32_t*)(bytes + animation->movingOffset);
+            valid = valid && (starts[0] == 0 && starts[animation->segmentCount] <= header->vertexCount - animation->movingCount &&
+                              animation->segmentOffset + (animation->segmentCount + 1 + starts[animation->segmentCount]) * sizeof(uint32_t) <= header->fileSize);
+            for (uint32_t s = 0; s < animation->segmentCount && valid; s++) {
+                valid = (starts[s] <= starts[s + 1] && starts[s + 1] <= starts[animation->segmentCount]);
+                for (uint32_t j = starts[s]; j < starts[s + 1] && valid; j++) {
+                    uint32_t vertex = segmentVertices[j];
+                    uint32_t m = Anim4dcFindMovingVertex(moving, animation->movingCount, vertex);
+                    valid = (vertex < header->vertexCount && (j == starts[s] || vertex > segmentVertices[j - 1]) &&
+                             (m >= animation->movingCount || moving[m] != vertex));
+                }
+            }
+        }
+        if (!valid) {
+            printf("Anim4DC: ERROR - Corrupt animation table entry %u\n", (unsigned)a);
+            return false;
+        }
+        
+        uint32_t vertexBytes = compressed ? 0 : Anim4dcKeyframeDataSize((Anim4dcStorageMode)header->storage, storedVertices);
+        for (uint32_t k = animation->firstKeyframe; k < animation->firstKeyframe + animation->keyframeCount; k++) {
+            if ((keyframeTable[k].vertexOffset & 3) != 0 || 
+                keyframeTable[k].vertexOffset + vertexBytes > header->fileSize) {
+                printf("Anim4DC: ERROR - Corrupt keyframe table entry %u\n", (unsigned)k);
+                return false;
+            }
+        }
+    }
+    
+    // Mesh variants: sources must stay inside their mesh's full resolution block, indices inside the variant's
+    const Anim4dcBakedVariant *variantTable = (const Anim4dcBakedVariant*)(bytes + header->variantOffset);
+    uint32_t previousLevel = ANIM4DC_LOD_NEAR;
+    for (uint32_t v = 0; v < header->variantCount; v++) {
+        const Anim4dcBakedVariant *variant = &variantTable[v];
+        uint32_t variantVertices = 0;
+        uint32_t variantIndices = 0;
+        bool valid = (variant->lodLevel > previousLevel && variant->lodLevel < ANIM4DC_MAX_MESH_VARIANTS &&
+                      variant->vertexCount > 0 && variant->vertexCount <= header->fileSize / sizeof(uint32_t) &&
+                      (variant->sourceOffset & 3) == 0 && (variant->indexOffset & 1) == 0 &&
+                      variant->keyframeOffset + header->keyframeCount * sizeof(Anim4dcBakedKeyframe) <= header->fileSize &&
+                      variant->sourceOffset + variant->vertexCount * sizeof(uint32_t) <= header->fileSize);
+        
+        for (uint32_t r = 0; r < header->meshCount && valid; r++) {
+            valid = (variant->meshVertexCounts[r] <= meshTable[r].vertexCount && variant->meshIndexCounts[r] % 3 == 0 &&
+                     variant->meshIndexCounts[r] <= header->fileSize / sizeof(unsigned short));
+            variantVertices += variant->meshVertexCounts[r];
+            variantIndices += variant->meshIndexCounts[r];
+        }
+        valid = valid && (variantVertices == variant->vertexCount) && (variantIndices <= header->fileSize / sizeof(unsigned short)) &&
+                (variant->indexOffset + variantIndices * sizeof(unsigned short) <= header->fileSize);
+        
+        const uint32_t *sources = (const uint32_t*)(bytes + variant->sourceOffset);
+        const unsigned short *indices = (const unsigned short*)(bytes + variant->indexOffset);
+        uint32_t vertexBase = 0;
+        for (uint32_t r = 0; r < header->meshCount && valid; r++) {
+            for (uint32_t i = 0; i < variant->meshVertexCounts[r] && valid; i++) {
+                uint32_t source = sources[vertexBase + i];
+                valid = (source >= meshTable[r].vertexOffset && source - meshTable[r].vertexOffset < meshTable[r].vertexCount);
+            }
+            for (uint32_t i = 0; i < variant->meshIndexCounts[r] && valid; i++) valid = (indices[i] < variant->meshVertexCounts[r]);
+            vertexBase += variant->meshVertexCounts[r];
+            indices += variant->meshIndexCounts[r];
+        }
+        
+        uint32_t variantBytes = Anim4dcKeyframeDataSize((Anim4dcStorageMode)header->storage, variant->vertexCount);
+        const Anim4dcBakedKeyframe *variantKeyframes = (const Anim4dcBakedKeyframe*)(bytes + variant->keyframeOffset);
+        for (uint32_t k = 0; k < header->keyframeCount && valid; k++) {
+            valid = ((variantKeyframes[k].vertexOffset & 3) == 0 && variantKeyframes[k].vertexOffset + variantBytes <= header->fileSize);
+        }
+        
+        if (!valid) {
+            printf("Anim4DC: ERROR - Corrupt variant table entry %u\n", (unsigned)v);
+            return false;
+        }
+        previousLevel = variant->lodLevel;
+    }
+    
+    return true;
+}
+
+// Build a baked model over a validated file image, descriptors are carved from the arena
+// The model takes the arena over, it is freed on failure too
+static Anim4dcBakedModel *Anim4dcCreateFromBaked(unsigned char *bytes, void *arena, int arenaSize) {
+    Anim4dcBakedModel *baked = Anim4dcCreateBakedModel();
+    if (!baked) {
+        free(arena);
+        return NULL;
+    }
+    
+    const Anim4dcBakedHeader *header = (const Anim4dcBakedHeader*)bytes;
+    const Anim4dcBakedMesh *meshTable = (const Anim4dcBakedMesh*)(bytes + header->meshOffset);
+    const Anim4dcBakedAnimation *animTable = (const Anim4dcBakedAnimation*)(bytes + header->animationOffset);
+    const Anim4dcBakedKeyframe *keyframeTable = (const Anim4dcBakedKeyframe*)(bytes + header->keyframeOffset);
+    
+    baked->arena = arena;
+    baked->arenaSize = arenaSize;
+    baked->animations = (Anim4dcVertexAnimation*)Anim4dcArenaBase(arena);
+    baked->animationCount = header->animationCount;
+    baked->vertexCount = header->vertexCount;
+    baked->storage = (Anim4dcStorageMode)header->storage;
+    baked->restPose = (header->restOffset != 0) ? (float*)(bytes + header->restOffset) : NULL;
+    baked->meshCount = header->meshCount;
+    for (int r = 0; r < baked->meshCount; r++) {
+        baked->meshes[r].meshIndex = meshTable[r].meshIndex;
+        baked->meshes[r].vertexOffset = meshTable[r].vertexOffset;
+        baked->meshes[r].vertexCount = meshTable[r].vertexCount;
+        baked->meshes[r].sourceVertexCount = meshTable[r].sourceVertexCount;
+    }
+    
+    // Keyframe descriptors follow the animations in the same order as the file's keyframe table,
+    // then come each mesh variant's
+    Anim4dcVertexKeyframe *keyframes = (Anim4dcVertexKeyframe*)(baked->animations + baked->animationCount);
+    memset(baked->animations, 0, Anim4dcArenaDescriptorSize(header->animationCount, header->keyframeCount * (1 + header->variantCount)));
+    
+    // Point keyframes straight into the file data, nothing is copied
+    for (int a = 0; a < baked->animationCount; a++) {
+        Anim4dcVertexAnimation *animation = &baked->animations[a];
+        
+        memcpy(animation->name, animTable[a].name, ANIM4DC_MAX_NAME_LENGTH);
+        animation->name[ANIM4DC_MAX_NAME_LENGTH - 1] = '\0';
+        animation->duration = animTable[a].duration;
+        animation->keyframes = keyframes + animTable[a].firstKeyframe;
+        animation->keyframeCount = animTable[a].keyframeCount;
+        animation->looping = (animTable[a].looping != 0);
+        if (animTable[a].movingOffset != 0) {
+            animation->movingVertices = (uint32_t*)(bytes + animTable[a].movingOffset);
+            animation->movingCount = animTable[a].movingCount;
+        }
+        if (animTable[a].basisOffset != 0) {
+            animation->basis = (float*)(bytes + animTable[a].basisOffset);
+            animation->coefficients = (float*)(bytes + animTable[a].coefficientOffset);
+            animation->basisCount = animTable[a].basisCount;
+        }
+        if (animTable[a].segmentOffset != 0) {
+            animation->segmentStarts = (uint32_t*)(bytes + animTable[a].segmentOffset);
+            animation->segmentVertices = animation->segmentStarts + animTable[a].segmentCount + 1;
+            animation->transforms = (float*)(bytes + animTable[a].transformOffset);
+            animation->segmentCount = animTable[a].segmentCount;
+        }
+        
+        for (int k = 0; k < animation->keyframeCount; k++) {
+            const Anim4dcBakedKeyframe *entry = &keyframeTable[animTable[a].firstKeyframe + k];
+            Anim4dcVertexKeyframe *keyframe = &animation->keyframes[k];
+            
+            if (animation->basis) {
+                keyframe->basis = animation->basis;
+                keyframe->coefficients = animation->coefficients + k * animation->basisCount;
+                keyframe->basisCount = animation->basisCount;
+            } else if (baked->storage == ANIM4DC_STORAGE_FLOAT) {
+                keyframe->vertices = (float*)(bytes + entry->vertexOffset);
+            } else {
+                keyframe->quantized = (short*)(bytes + entry->vertexOffset);
+                keyframe->offset = (Vector3){ entry->offset[0], entry->offset[1], entry->offset[2] };
+                keyframe->scale = (Vector3){ entry->scale[0], entry->scale[1], entry->scale[2] };
+            }
+            keyframe->vertexCount = animation->movingVertices ? animation->movingCount : baked->vertexCount;
+            keyframe->timestamp = entry->timestamp;
+            if (animation->movingVertices) {
+                keyframe->rest = baked->restPose;
+                keyframe->moving = animation->movingVertices;
+            }
+            if (animation->segmentStarts) {
+                keyframe->transforms = animation->transforms + k * animation->segmentCount * 12;
+                keyframe->segmentVertices = animation->segmentVertices;
+                keyframe->segmentStarts = animation->segmentStarts;
+                keyframe->segmentCount = animation->segmentCount;
+            }
+        }
+        Anim4dcDetectKeyframeInterval(animation);
+    }
+    
+    const Anim4dcBakedVariant *variantTable = (const Anim4dcBakedVariant*)(bytes + header->variantOffset);
+    Anim4dcVertexKeyframe *variantKeyframes = keyframes + header->keyframeCount;
+    for (uint32_t v = 0; v < header->variantCount; v++) {
+        const Anim4dcBakedVariant *entry = &variantTable[v];
+        const Anim4dcBakedKeyframe *table = (const Anim4dcBakedKeyframe*)(bytes + entry->keyframeOffset);
+        Anim4dcMeshVariant *variant = &baked->variants[entry->lodLevel];
+        
+        variant->vertexCount = entry->vertexCount;
+        for (int r = 0; r < baked->meshCount; r++) {
+            variant->meshes[r].meshIndex = baked->meshes[r].meshIndex;
+            variant->meshes[r].vertexOffset = (r > 0) ? variant->meshes[r - 1].vertexOffset + variant->meshes[r - 1].vertexCount : 0;
+            variant->meshes[r].vertexCount = entry->meshVertexCounts[r];
+            variant->indexCounts[r] = entry->meshIndexCounts[r];
+            variant->indexCount += entry->meshIndexCounts[r];
+        }
+        variant->sourceVertices = (uint32_t*)(bytes + entry->sourceOffset);
+        variant->indices = (unsigned short*)(bytes + entry->indexOffset);
+        variant->keyframes = variantKeyframes;
+        
+        for (uint32_t k = 0; k < header->keyframeCount; k++) {
+            Anim4dcVertexKeyframe *keyframe = &variantKeyframes[k];
+            if (baked->storage == ANIM4DC_STORAGE_FLOAT) {
+                keyframe->vertices = (float*)(bytes + table[k].vertexOffset);
+            } else {
+                keyframe->quantized = (short*)(bytes + table[k].vertexOffset);
+                keyframe->offset = (Vector3){ table[k].offset[0], table[k].offset[1], table[k].offset[2] };
+                keyframe->scale = (Vector3){ table[k].scale[0], table[k].scale[1], table[k].scale[2] };
+            }
+            keyframe->vertexCount = variant->vertexCount;
+            keyframe->timestamp = table[k].timestamp;
+        }
+        variantKeyframes += header->keyframeCount;
+    }
+    
+    if (!Anim4dcFinishAnimationSetup(baked)) {
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    printf("Anim4DC: Loaded %d baked animations (%u keyframes)\n", baked->animationCount, (unsigned)header->keyframeCount);
+    return baked;
+}
+
+// Write data zero padded to the block alignment
+static bool Anim4dcWriteAligned(FILE *file, const void *data, uint32_t size) {
+    static const unsigned char padding[ANIM4DC_BAKED_ALIGNMENT] = { 0 };
+    uint32_t padded = Anim4dcAlignOffset(size);
+    
+    bool success = (size == 0) || (fwrite(data, size, 1, file) == 1);
+    if (success && padded > size) success = (fwrite(padding, padded - size, 1, file) == 1);
+    return success;
+}
+
+// Write the keyframe table of the full resolution meshes or a mesh variant, blocks numbered on from vertexOffset
+static bool Anim4dcWriteKeyframeTable(FILE *file, const Anim4dcBakedModel *baked, int meshVariant, uint32_t vertexOffset) {
+    bool success = true;
+    
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexKeyframe *keyframes = Anim4dcGetVariantKeyframes(baked, meshVariant, a);
+        
+        for (int k = 0; k < baked->animations[a].keyframeCount && success; k++) {
+            const Anim4dcVertexKeyframe *keyframe = &keyframes[k];
+            Anim4dcBakedKeyframe entry = { 0 };
+            entry.timestamp = keyframe->timestamp;
+            entry.vertexOffset = vertexOffset;
+            entry.offset[0] = keyframe->offset.x;
+            entry.offset[1] = keyframe->offset.y;
+            entry.offset[2] = keyframe->offset.z;
+            entry.scale[0] = keyframe->scale.x;
+            entry.scale[1] = keyframe->scale.y;
+            entry.scale[2] = keyframe->scale.z;
+            vertexOffset += Anim4dcAlignOffset(Anim4dcKeyframeBytes(baked->storage, keyframe));
+            
+            success = (fwrite(&entry, sizeof(entry), 1, file) == 1);
+        }
+    }
+    
+    return success;
+}
+
+// Write the vertex blocks of the full resolution meshes or a mesh variant, each zero padded to the alignment
+static bool Anim4dcWriteKeyframeBlocks(FILE *file, const Anim4dcBakedModel *baked, int meshVariant) {
+    bool success = true;
+    
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexKeyframe *keyframes = Anim4dcGetVariantKeyframes(baked, meshVariant, a);
+        
+        for (int k = 0; k < baked->animations[a].keyframeCount && success; k++) {
+            const void *vertexData = keyframes[k].quantized ? (const void*)keyframes[k].quantized : (const void*)keyframes[k].vertices;
+            success = Anim4dcWriteAligned(file, vertexData, Anim4dcKeyframeBytes(baked->storage, &keyframes[k]));
+        }
+    }
+    
+    return success;
+}
+
+//----------------------------------------------------------------------------------
+// Animation System Core Functions Implementation
+//----------------------------------------------------------------------------------
+
+bool Anim4dcInit(void) {
+    if (anim4dc.initialized) return true;
+    
+    memset(&anim4dc, 0, sizeof(Anim4dcSystem));
+    anim4dc.lodPolicy = Anim4dcGetDefaultLodPolicy();
+    anim4dc.initialized = true;
+    
+    // Fastest kernel this build and CPU support
+    for (int kernel = ANIM4DC_KERNEL_COUNT - 1; kernel > ANIM4DC_KERNEL_SCALAR; kernel--) {
+        if (Anim4dcSetKernel((Anim4dcKernel)kernel)) break;
+    }
+    
+    printf("Anim4DC v%s initialized (%s kernel)\n", ANIM4DC_VERSION, Anim4dcGetKernelName(anim4dc.kernel));
+    return true;
+}
+
+void Anim4dcShutdown(void) {
+    if (!anim4dc.initialized) return;
+    
+    while (anim4dc.models) Anim4dcUnloadBakedModel(anim4dc.models);
+    
+    memset(&anim4dc, 0, sizeof(Anim4dcSystem));
+    printf("Anim4DC shutdown complete\n");
+}
+
+void Anim4dcUnloadBakedModel(Anim4dcBakedModel *baked) {
+    if (!baked) return;
+    
+    // Unlink from the live model list
+    for (Anim4dcBakedModel **link = &anim4dc.models; *link; link = &(*link)->next) {
+        if (*link == baked) {
+            *link = baked->next;
+            break;
+        }
+    }
+    
+    Anim4dcUnloadAnimations(baked);
+    free(baked);
+}
+
+bool Anim4dcCheckModelCompatibility(Model model, ModelAnimation *animations, int animationCount) {
+    if (model.meshCount <= 0) {
+        printf("Anim4DC: ERROR - No meshes in model\n");
+        return false;
+    }
+    
+    if (animationCount <= 0) {
+        printf("Anim4DC: Model loaded as static (no animations)\n");
+        return false;
+    }
+    
+    if (model.boneCount <= 0) {
+        printf("Anim4DC: ERROR - Model has no bones\n");
+        return false;
+    }
+    
+    if (model.bones == NULL || model.bindPose == NULL) {
+        printf("Anim4DC: ERROR - Model missing bone hierarchy\n");
+        return false;
+    }
+    
+    // Check first animation
+    ModelAnimation anim = animations[0];
+    if (anim.boneCount != model.boneCount) {
+        printf("Anim4DC: ERROR - Bone count mismatch! Model:%d != Anim:%d\n", 
+               model.boneCount, anim.boneCount);
+        return false;
+    }
+    
+    if (anim.bones == NULL || anim.framePoses == NULL) {
+        printf("Anim4DC: ERROR - Animation missing data\n");
+        return false;
+    }
+    
+    // Check for skinning data
+    bool hasSkinning = false;
+    for (int i = 0; i < model.meshCount; i++) {
+        Mesh mesh = model.meshes[i];
+        if (mesh.boneIds && mesh.boneWeights && mesh.animVertices) {
+            hasSkinning = true;
+            break;
+        }
+    }
+    
+    if (!hasSkinning) {
+        printf("Anim4DC: ERROR - Model missing skinning data\n");
+        return false;
+    }
+    
+    printf("Anim4DC: Model compatibility check passed\n");
+    return true;
+}
+
+Anim4dcBakedModel *Anim4dcBakeVertexAnimations(Model model, ModelAnimation *animations, int animationCount) {
+    return Anim4dcBakeVertexAnimationsEx(model, animations, animationCount, Anim4dcGetDefaultBakeOptions(), NULL);
+}
+
+Anim4dcBakeOptions Anim4dcGetDefaultBakeOptions(void) {
+    Anim4dcBakeOptions options = { 0 };
+    options.maxError = 0.0f;
+    options.storage = ANIM4DC_STORAGE_FLOAT;
+    options.sourceFrameRate = ANIM4DC_SOURCE_FRAME_RATE;
+    options.targetFrameRate = 0.0f;
+    return options;
+}
+
+float Anim4dcGetSourceFrameRate(const char *fileName) {
+    if (!fileName || !IsFileExtension(fileName, ".iqm")) return ANIM4DC_SOURCE_FRAME_RATE;
+    
+    // IQM keeps one frame per stored pose, at the rate written in its first animation entry
+    float frameRate = ANIM4DC_SOURCE_FRAME_RATE;
+    FILE *file = fopen(fileName, "rb");
+    if (!file) return frameRate;
+    
+    unsigned char header[16 + 19 * sizeof(uint32_t)];
+    if (fread(header, sizeof(header), 1, file) == 1 && memcmp(header, "INTERQUAKEMODEL", 16) == 0) {
+        uint32_t animationCount = 0;
+        uint32_t animationOffset = 0;
+        memcpy(&animationCount, header + 16 + 17 * sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&animationOffset, header + 16 + 18 * sizeof(uint32_t), sizeof(uint32_t));
+        
+        float fileRate = 0.0f;
+        if (animationCount > 0 && fseek(file, animationOffset + 3 * sizeof(uint32_t), SEEK_SET) == 0 &&
+            fread(&fileRate, sizeof(float), 1, file) == 1 && fileRate > 0.0f) {
+            frameRate = fileRate;
+        }
+    }
+    
+    fclose(file);
+    return frameRate;
+}
+
+Anim4dcBakedModel *Anim4dcBakeVertexAnimationsEx(Model model, ModelAnimation *animations, int animationCount, 
+                                                 Anim4dcBakeOptions options, Anim4dcBakeReport *reports) {
+    if (!anim4dc.initialized) {
+        printf("Anim4DC: ERROR - System not initialized\n");
+        return NULL;
+    }
+    
+    if (!Anim4dcCheckModelCompatibility(model, animations, animationCount)) {
+        return NULL;
+    }
+    
+    // Default animation names
+    const char* animNames[] = {"Survey", "Walk", "Run", "Jump", "Idle", "Attack", "Death", "Custom"};
+    int animNameCount = sizeof(animNames) / sizeof(animNames[0]);
+    
+    Anim4dcBakedModel *baked = Anim4dcCreateBakedModel();
+    if (!baked) return NULL;
+    
+    // Animations and keyframes are staged on the heap, then packed into the model arena
+    baked->animations = (Anim4dcVertexAnimation*)calloc(animationCount, sizeof(Anim4dcVertexAnimation));
+    if (!baked->animations) {
+        printf("Anim4DC: ERROR - Failed to allocate %d animations\n", animationCount);
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    // Every skinned mesh gets its own block of vertices in each keyframe,
+    // welded meshes are skinned and baked for their unique vertices only
+    for (int m = 0; m < model.meshCount; m++) {
+        Mesh *mesh = &model.meshes[m];
+        if (!Anim4dcIsSkinnedMesh(mesh)) continue;
+        
+        if (baked->meshCount >= ANIM4DC_MAX_MESHES) {
+            printf("Anim4DC: WARNING - Only the first %d skinned meshes are baked\n", ANIM4DC_MAX_MESHES);
+            break;
+        }
+        
+        baked->meshes[baked->meshCount].sourceVertexCount = mesh->vertexCount;
+        if (options.weldVertices) Anim4dcWeldMesh(mesh, m);
+        
+        baked->meshes[baked->meshCount].meshIndex = m;
+        baked->meshes[baked->meshCount].vertexOffset = baked->vertexCount;
+        baked->meshes[baked->meshCount].vertexCount = mesh->vertexCount;
+        baked->meshCount++;
+        baked->vertexCount += mesh->vertexCount;
+    }
+    
+    baked->animationCount = animationCount;
+    
+    for (int a = 0; a < animationCount; a++) {
+        ModelAnimation skelAnim = animations[a];
+        Anim4dcVertexAnimation *vertAnim = &baked->animations[a];
+        
+        // Setup vertex animation
+        snprintf(vertAnim->name, ANIM4DC_MAX_NAME_LENGTH, "%s", 
+                 (a < animNameCount) ? animNames[a] : "Unknown");
+        vertAnim->keyframeCount = 0;
+        vertAnim->duration = skelAnim.frameCount / ((options.sourceFrameRate > 0.0f) ? options.sourceFrameRate : ANIM4DC_SOURCE_FRAME_RATE);
+        vertAnim->looping = true;
+        
+        printf("Anim4DC: Baking animation %d: %s (%d frames)\n", 
+               a, vertAnim->name, skelAnim.frameCount);
+        
+        if (!Anim4dcBakeKeyframes(baked, model, skelAnim, vertAnim, options, reports ? &reports[a] : NULL)) {
+            Anim4dcUnloadBakedModel(baked);
+            return NULL;
+        }
+        Anim4dcDetectKeyframeInterval(vertAnim);
+    }
+    
+    Anim4dcSkipStaticMeshes(baked, model);
+    if (baked->vertexCount == 0) {
+        printf("Anim4DC: ERROR - No mesh moves in any animation, nothing to bake\n");
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    if (!Anim4dcBuildMeshVariants(baked, model, options.lodVertexCounts)) {
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    // Sparse animations store deltas, quantizing them afterwards gets boxes around the motion only
+    for (int a = 0; a < animationCount && reports; a++) {
+        reports[a].movingVertices = baked->vertexCount;
+        reports[a].basisShapes = 0;
+        reports[a].basisError = 0.0f;
+        reports[a].rigidSegments = 0;
+        reports[a].rigidVertices = 0;
+        reports[a].rigidError = 0.0f;
+    }
+    if (options.staticThreshold > 0.0f && !Anim4dcEncodeSparseAnimations(baked, model, options.staticThreshold, reports)) {
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    // Rigid segments take the vertices following one bone out of the keyframes, the deforming rest stays sparse
+    if (options.rigidMaxError > 0.0f && !Anim4dcEncodeRigidSegments(baked, model, options.rigidMaxError, options.storage, reports)) {
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    // Basis compression works on the float positions (or deltas), compressed animations skip quantization
+    for (int a = 0; a < animationCount && options.basisMaxError > 0.0f; a++) {
+        if (!Anim4dcCompressAnimationBasis(&baked->animations[a], options.storage, options.basisMaxError, reports ? &reports[a] : NULL)) {
+            Anim4dcUnloadBakedModel(baked);
+            return NULL;
+        }
+    }
+    
+    for (int a = 0; a < animationCount; a++) {
+        Anim4dcVertexAnimation *vertAnim = &baked->animations[a];
+        
+        if (options.storage != ANIM4DC_STORAGE_FLOAT && !vertAnim->basis) {
+            float quantizationError = 0.0f;
+            if (!Anim4dcQuantizeAnimation(vertAnim, options.storage, &quantizationError)) {
+                Anim4dcUnloadBakedModel(baked);
+                return NULL;
+            }
+            if (reports) reports[a].quantizationError = quantizationError;
+            
+            printf("Anim4DC: Quantized %s to 16-bit (max error %.4f)\n", vertAnim->name, quantizationError);
+        }
+        if (reports) reports[a].keyframeBytes = Anim4dcAnimationDataSize(options.storage, vertAnim);
+    }
+    
+    // Mesh variant keyframes get the same storage, quantized one animation at a time
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS && options.storage != ANIM4DC_STORAGE_FLOAT; v++) {
+        if (baked->variants[v].vertexCount <= 0) continue;
+        
+        int firstKeyframe = 0;
+        for (int a = 0; a < animationCount; a++) {
+            Anim4dcVertexAnimation slice = baked->animations[a];
+            slice.keyframes = baked->variants[v].keyframes + firstKeyframe;
+            firstKeyframe += slice.keyframeCount;
+            
+            float quantizationError = 0.0f;
+            if (!Anim4dcQuantizeAnimation(&slice, options.storage, &quantizationError)) {
+                Anim4dcUnloadBakedModel(baked);
+                return NULL;
+            }
+        }
+    }
+    
+    baked->storage = options.storage;
+    
+    if (!Anim4dcPackArena(baked) || !Anim4dcFinishAnimationSetup(baked)) {
+        Anim4dcUnloadBakedModel(baked);
+        return NULL;
+    }
+    
+    printf("Anim4DC: Vertex animation baking complete! %d meshes, using %d KB memory\n", 
+           baked->meshCount, baked->stats.memoryUsageKB);
+    
+    return baked;
+}
+
+bool Anim4dcSaveBaked(const Anim4dcBakedModel *baked, const char *fileName) {
+    if (!baked || baked->animationCount <= 0 || !fileName) {
+        printf("Anim4DC: ERROR - No baked animations to save\n");
+        return false;
+    }
+    
+    int keyframeCount = 0;
+    for (int a = 0; a < baked->animationCount; a++) keyframeCount += baked->animations[a].keyframeCount;
+    
+    uint32_t blocksSize = Anim4dcKeyframeBlocksSize(baked, 0);
+    int variantCount = Anim4dcCountMeshVariants(baked);
+    
+    Anim4dcBakedHeader header = { 0 };
+    memcpy(header.magic, ANIM4DC_BAKED_MAGIC, 4);
+    header.version = ANIM4DC_BAKED_VERSION;
+    header.animationCount = baked->animationCount;
+    header.keyframeCount = keyframeCount;
+    header.vertexCount = baked->vertexCount;
+    header.storage = baked->storage;
+    header.meshCount = baked->meshCount;
+    header.meshOffset = sizeof(Anim4dcBakedHeader);
+    header.animationOffset = header.meshOffset + baked->meshCount * sizeof(Anim4dcBakedMesh);
+    header.keyframeOffset = header.animationOffset + baked->animationCount * sizeof(Anim4dcBakedAnimation);
+    header.variantCount = variantCount;
+    header.variantOffset = header.keyframeOffset + keyframeCount * sizeof(Anim4dcBakedKeyframe);
+    
+    uint32_t tablesEnd = header.variantOffset + variantCount * (sizeof(Anim4dcBakedVariant) + keyframeCount * sizeof(Anim4dcBakedKeyframe));
+    uint32_t dataOffset = Anim4dcAlignOffset(tablesEnd);
+    header.restOffset = baked->restPose ? dataOffset + blocksSize : 0;
+    header.fileSize = dataOffset + blocksSize + Anim4dcSparseDataSize(baked) + Anim4dcBasisBlocksSize(baked) + Anim4dcRigidBlocksSize(baked);
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) header.fileSize += Anim4dcVariantDataSize(baked->storage, &baked->variants[v], keyframeCount);
+    
+    FILE *file = fopen(fileName, "wb");
+    if (!file) {
+        printf("Anim4DC: ERROR - Failed to open %s for writing\n", fileName);
+        return false;
+    }
+    
+    bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+    
+    // Mesh table
+    for (int r = 0; r < baked->meshCount && success; r++) {
+        Anim4dcBakedMesh entry = { 0 };
+        entry.meshIndex = baked->meshes[r].meshIndex;
+        entry.vertexOffset = baked->meshes[r].vertexOffset;
+        entry.vertexCount = baked->meshes[r].vertexCount;
+        entry.sourceVertexCount = baked->meshes[r].sourceVertexCount;
+        
+        success = (fwrite(&entry, sizeof(entry), 1, file) == 1);
+    }
+    
+    // Animation table, moving vertex lists follow the rest pose, then come basis shapes and rigid segments
+    int firstKeyframe = 0;
+    uint32_t movingOffset = header.restOffset + Anim4dcAlignOffset(baked->vertexCount * 3 * sizeof(float));
+    uint32_t basisOffset = dataOffset + blocksSize + Anim4dcSparseDataSize(baked);
+    uint32_t segmentOffset = basisOffset + Anim4dcBasisBlocksSize(baked);
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        Anim4dcBakedAnimation entry = { 0 };
+        
+        memcpy(entry.name, animation->name, ANIM4DC_MAX_NAME_LENGTH);
+        entry.duration = animation->duration;
+        entry.keyframeCount = animation->keyframeCount;
+        entry.firstKeyframe = firstKeyframe;
+        entry.looping = animation->looping ? 1 : 0;
+        firstKeyframe += animation->keyframeCount;
+        if (animation->movingVertices) {
+            entry.movingCount = animation->movingCount;
+            entry.movingOffset = movingOffset;
+            movingOffset += Anim4dcAlignOffset(animation->movingCount * sizeof(uint32_t));
+        }
+        if (animation->basis) {
+            entry.basisCount = animation->basisCount;
+            entry.basisOffset = basisOffset;
+            basisOffset += Anim4dcAlignOffset(Anim4dcBasisDataSize(animation->basisCount, animation->keyframes[0].vertexCount));
+            entry.coefficientOffset = basisOffset;
+            basisOffset += Anim4dcAlignOffset(animation->keyframeCount * animation->basisCount * sizeof(float));
+        }
+        if (animation->segmentStarts) {
+            entry.segmentCount = animation->segmentCount;
+            entry.segmentOffset = segmentOffset;
+            segmentOffset += Anim4dcAlignOffset(Anim4dcSegmentListSize(animation));
+            entry.transformOffset = segmentOffset;
+            segmentOffset += Anim4dcAlignOffset(animation->keyframeCount * animation->segmentCount * 12 * sizeof(float));
+        }
+        
+        success = (fwrite(&entry, sizeof(entry), 1, file) == 1);
+    }
+    
+    // Keyframe table
+    if (success) success = Anim4dcWriteKeyframeTable(file, baked, 0, dataOffset);
+    
+    // Variant table, each variant's data follows the previous one's after the keyframe blocks
+    uint32_t variantData[ANIM4DC_MAX_MESH_VARIANTS] = { 0 };
+    uint32_t dataEnd = dataOffset + blocksSize + Anim4dcSparseDataSize(baked) + Anim4dcBasisBlocksSize(baked) + Anim4dcRigidBlocksSize(baked);
+    int written = 0;
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS && success; v++) {
+        const Anim4dcMeshVariant *variant = &baked->variants[v];
+        if (variant->vertexCount <= 0) continue;
+        
+        Anim4dcBakedVariant entry = { 0 };
+        entry.lodLevel = v;
+        entry.vertexCount = variant->vertexCount;
+        for (int r = 0; r < baked->meshCount; r++) {
+            entry.meshVertexCounts[r] = variant->meshes[r].vertexCount;
+            entry.meshIndexCounts[r] = variant->indexCounts[r];
+        }
+        entry.keyframeOffset = header.variantOffset + variantCount * sizeof(Anim4dcBakedVariant) + 
+                               written * keyframeCount * sizeof(Anim4dcBakedKeyframe);
+        entry.sourceOffset = dataEnd + keyframeCount * Anim4dcAlignOffset(Anim4dcKeyframeDataSize(baked->storage, variant->vertexCount));
+        entry.indexOffset = entry.sourceOffset + Anim4dcAlignOffset(variant->vertexCount * sizeof(uint32_t));
+        
+        variantData[v] = dataEnd;
+        dataEnd += Anim4dcVariantDataSize(baked->storage, variant, keyframeCount);
+        written++;
+        
+        success = (fwrite(&entry, sizeof(entry), 1, file) == 1);
+    }
+    
+    // Variant keyframe tables
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS && success; v++) {
+        if (baked->variants[v].vertexCount <= 0) continue;
+        
+        success = Anim4dcWriteKeyframeTable(file, baked, v, variantData[v]);
+    }
+    
+    // Keyframe vertex blocks, zero padded to the block alignment
+    static const unsigned char padding[ANIM4DC_BAKED_ALIGNMENT] = { 0 };
+    if (success && dataOffset > tablesEnd) success = (fwrite(padding, dataOffset - tablesEnd, 1, file) == 1);
+    if (success) success = Anim4dcWriteKeyframeBlocks(file, baked, 0);
+    
+    // Rest pose and moving vertex lists of sparse animations
+    if (success && baked->restPose) success = Anim4dcWriteAligned(file, baked->restPose, baked->vertexCount * 3 * sizeof(float));
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (animation->movingVertices) success = Anim4dcWriteAligned(file, animation->movingVertices, animation->movingCount * sizeof(uint32_t));
+    }
+    
+    // Basis shapes and weights of basis compressed animations
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->basis) continue;
+        
+        success = Anim4dcWriteAligned(file, animation->basis, Anim4dcBasisDataSize(animation->basisCount, animation->keyframes[0].vertexCount)) &&
+                  Anim4dcWriteAligned(file, animation->coefficients, animation->keyframeCount * animation->basisCount * sizeof(float));
+    }
+    
+    // Segment starts and vertices, then transforms of rigid animations
+    for (int a = 0; a < baked->animationCount && success; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->segmentStarts) continue;
+        
+        success = Anim4dcWriteAligned(file, animation->segmentStarts, Anim4dcSegmentListSize(animation)) &&
+                  Anim4dcWriteAligned(file, animation->transforms, animation->keyframeCount * animation->segmentCount * 12 * sizeof(float));
+    }
+    
+    // Variant keyframe blocks, source vertices and indices
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS && success; v++) {
+        const Anim4dcMeshVariant *variant = &baked->variants[v];
+        if (variant->vertexCount <= 0) continue;
+        
+        success = Anim4dcWriteKeyframeBlocks(file, baked, v) &&
+                  Anim4dcWriteAligned(file, variant->sourceVertices, variant->vertexCount * sizeof(uint32_t)) &&
+                  Anim4dcWriteAligned(file, variant->indices, variant->indexCount * sizeof(unsigned short));
+    }
+    
+    fclose(file);
+    
+    if (!success) {
+        printf("Anim4DC: ERROR - Failed writing %s\n", fileName);
+        return false;
+    }
+    
+    printf("Anim4DC: Saved %d animations (%d keyframes, %d mesh variants, %u bytes) to %s\n", 
+           baked->animationCount, keyframeCount, variantCount, header.fileSize, fileName);
+    return true;
+}
+
+Anim4dcBakedModel *Anim4dcLoadBaked(const char *fileName) {
+    if (!anim4dc.initialized || !fileName) {
+        printf("Anim4DC: ERROR - System not initialized\n");
+        return NULL;
+    }
+    
+    FILE *file = fopen(fileName, "rb");
+    if (!file) {
+        printf("Anim4DC: ERROR - Failed to open %s\n", fileName);
+        return NULL;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    // The header counts size the descriptors placed in front of the file image
+    Anim4dcBakedHeader header = { 0 };
+    if (fileSize < (long)sizeof(header) || fread(&header, sizeof(header), 1, file) != 1 ||
+        header.animationCount > fileSize / sizeof(Anim4dcBakedAnimation) || 
+        header.keyframeCount > fileSize / sizeof(Anim4dcBakedKeyframe) || header.variantCount >= ANIM4DC_MAX_MESH_VARIANTS) {
+        printf("Anim4DC: ERROR - Corrupt baked file %s\n", fileName);
+        fclose(file);
+        return NULL;
+    }
+    
+    // One arena holds the descriptors and the whole file, aligned so keyframe blocks land on cache lines
+    uint32_t descriptorSize = Anim4dcArenaDescriptorSize(header.animationCount, header.keyframeCount * (1 + header.variantCount));
+    int arenaSize = descriptorSize + fileSize + ANIM4DC_BAKED_ALIGNMENT - 1;
+    void *arena = malloc(arenaSize);
+    if (!arena) {
+        printf("Anim4DC: ERROR - Failed to allocate %d bytes for %s\n", arenaSize, fileName);
+        fclose(file);
+        return NULL;
+    }
+    
+    unsigned char *data = Anim4dcArenaBase(arena) + descriptorSize;
+    fseek(file, 0, SEEK_SET);
+    size_t bytesRead = fread(data, 1, fileSize, file);
+    fclose(file);
+    
+    if ((long)bytesRead != fileSize || !Anim4dcValidateBaked(data, (int)fileSize)) {
+        printf("Anim4DC: ERROR - Failed to load %s\n", fileName);
+        free(arena);
+        return NULL;
+    }
+    
+    return Anim4dcCreateFromBaked(data, arena, arenaSize);
+}
+
+Anim4dcBakedModel *Anim4dcLoadBakedFromMemory(void *data, int dataSize) {
+    if (!anim4dc.initialized || !data || !Anim4dcValidateBaked((const unsigned char*)data, dataSize)) return NULL;
+    
+    // Vertex blocks stay in the caller's memory, the arena only holds the descriptors
+    const Anim4dcBakedHeader *header = (const Anim4dcBakedHeader*)data;
+    int arenaSize = Anim4dcArenaDescriptorSize(header->animationCount, header->keyframeCount * (1 + header->variantCount)) + ANIM4DC_BAKED_ALIGNMENT - 1;
+    void *arena = malloc(arenaSize);
+    if (!arena) {
+        printf("Anim4DC: ERROR - Failed to allocate %d byte model arena\n", arenaSize);
+        return NULL;
+    }
+    
+    return Anim4dcCreateFromBaked((unsigned char*)data, arena, arenaSize);
+}
+
+void Anim4dcUpdateAnimation(Anim4dcBakedModel *baked, float deltaTime) {
+    if (!baked || baked->currentAnimation < 0 || 
+        baked->currentAnimation >= baked->animationCount) {
+        return;
+    }
+    
+    Anim4dcVertexAnimation *currentAnim = &baked->animations[baked->currentAnimation];
+    if (currentAnim->keyframeCount < 2 || (!baked->outputVertices && !baked->outputMeshes)) return;
+    if (baked->paused) deltaTime = 0.0f;
+    
+    // Update animation time, wrapped (or clamped) the same way as instance clocks
+    baked->currentTime = Anim4dcWrapAnimationTime(currentAnim, baked->currentTime + deltaTime);
+    
+    // Find current and next keyframes from the playback cursor
+    int nextKeyframe = 1;
+    float t = 0.0f;
+    Anim4dcResolveKeyframes(currentAnim, baked->currentTime, &baked->currentKeyframe, &nextKeyframe, &t);
+    
+    // The animation fading out keeps playing until the crossfade completes
+    if (baked->fadeAnimation >= 0) {
+        Anim4dcVertexAnimation *fading = &baked->animations[baked->fadeAnimation];
+        baked->fadeElapsed += deltaTime;
+        
+        if (baked->fadeElapsed >= baked->fadeDuration || fading->duration <= 0.0f) {
+            baked->fadeAnimation = -1;
+        } else {
+            baked->fadeTime = Anim4dcWrapAnimationTime(fading, baked->fadeTime + deltaTime);
+            int fadeNext = 0;
+            float fadeBlend = 0.0f;
+            Anim4dcResolveKeyframes(fading, baked->fadeTime, &baked->fadeKeyframe, &fadeNext, &fadeBlend);
+        }
+    }
+    
+    // Interpolate vertices straight into the output
+    if (baked->outputMeshes) {
+        for (int r = 0; r < baked->meshCount; r++) {
+            Anim4dcMeshRange *range = &baked->meshes[r];
+            Anim4dcWriteGlobalPose(baked, baked->outputMeshes[range->meshIndex].vertices, 0, range->vertexOffset, range->vertexCount);
+        }
+        return;
+    }
+    
+    Anim4dcWriteGlobalPose(baked, baked->outputVertices, baked->outputStride, 0, baked->vertexCount);
+}
+
+float *Anim4dcGetInterpolatedVertices(const Anim4dcBakedModel *baked) {
+    return baked->outputVertices;
+}
+
+bool Anim4dcSetOutputBuffer(Anim4dcBakedModel *baked, float *destination, int stride) {
+    if (!baked || baked->vertexCount <= 0) {
+        printf("Anim4DC: ERROR - No baked animations to output\n");
+        return false;
+    }
+    
+    if (stride <= 0) stride = 3 * sizeof(float);
+    if (stride < (int)(3 * sizeof(float))) {
+        printf("Anim4DC: ERROR - Output stride %d is smaller than a position\n", stride);
+        return false;
+    }
+    
+    baked->outputMeshes = NULL;
+    
+    if (destination) {
+        // Caller owns the output now, the internal buffer and its copy are no longer needed
+        free(baked->interpolationBuffer);
+        baked->interpolationBuffer = NULL;
+        baked->outputVertices = destination;
+        baked->outputStride = stride;
+    } else {
+        if (!baked->interpolationBuffer) {
+            baked->interpolationBuffer = (float*)malloc(baked->vertexCount * 3 * sizeof(float));
+            if (!baked->interpolationBuffer) {
+                printf("Anim4DC: ERROR - Failed to allocate interpolation buffer\n");
+                baked->outputVertices = NULL;
+                return false;
+            }
+        }
+        baked->outputVertices = baked->interpolationBuffer;
+        baked->outputStride = 3 * sizeof(float);
+    }
+    
+    baked->stats.memoryUsageKB = Anim4dcCalculateMemoryUsage(baked);
+    return true;
+}
+
+bool Anim4dcSetOutputMesh(Anim4dcBakedModel *baked, Mesh *mesh) {
+    if (!baked) {
+        printf("Anim4DC: ERROR - No baked animations to output\n");
+        return false;
+    }
+    
+    if (!mesh || !mesh->vertices || baked->meshCount != 1 || mesh->vertexCount != baked->vertexCount) {
+        printf("Anim4DC: ERROR - Output mesh does not match the baked vertices (%d meshes, %d vertices)\n", 
+               baked->meshCount, baked->vertexCount);
+        return false;
+    }
+    
+    return Anim4dcSetOutputBuffer(baked, mesh->vertices, 0);
+}
+
+bool Anim4dcSetOutputModel(Anim4dcBakedModel *baked, Model *model) {
+    if (!baked || !model || !Anim4dcCheckModelLayout(baked, *model)) {
+        printf("Anim4DC: ERROR - Output model does not match the baked mesh layout\n");
+        return false;
+    }
+    
+    // Release the internal buffer, then route output into the meshes
+    if (!Anim4dcSetOutputBuffer(baked, model->meshes[baked->meshes[0].meshIndex].vertices, 0)) return false;
+    baked->outputVertices = NULL;
+    baked->outputMeshes = model->meshes;
+    return true;
+}
+
+bool Anim4dcCheckModelLayout(const Anim4dcBakedModel *baked, Model model) {
+    if (baked->meshCount <= 0) return false;
+    
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Anim4dcMeshRange *range = &baked->meshes[r];
+        if (range->meshIndex >= model.meshCount || !model.meshes[range->meshIndex].vertices ||
+            model.meshes[range->meshIndex].vertexCount != range->vertexCount) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool Anim4dcMatchModelLayout(const Anim4dcBakedModel *baked, Model *model) {
+    if (!baked || !model) return false;
+    
+    // Welding is deterministic, so a mesh loaded from the same file welds to the baked layout again
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Anim4dcMeshRange *range = &baked->meshes[r];
+        if (range->meshIndex >= model->meshCount || range->sourceVertexCount == range->vertexCount) continue;
+        
+        Mesh *mesh = &model->meshes[range->meshIndex];
+        if (mesh->vertexCount == range->sourceVertexCount && Anim4dcIsSkinnedMesh(mesh)) Anim4dcWeldMesh(mesh, range->meshIndex);
+    }
+    
+    return Anim4dcCheckModelLayout(baked, *model);
+}
+
+int Anim4dcGetVertexCount(const Anim4dcBakedModel *baked) {
+    return baked->vertexCount;
+}
+
+//------------------------------------------------------------------------------------
+// Animation Control Functions Implementation
+//------------------------------------------------------------------------------------
+
+bool Anim4dcSetAnimation(Anim4dcBakedModel *baked, int animationIndex) {
+    if (!baked || animationIndex < 0 || animationIndex >= baked->animationCount) {
+        return false;
+    }
+    
+    baked->currentAnimation = animationIndex;
+    baked->currentTime = 0.0f;
+    baked->currentKeyframe = 0;
+    baked->fadeAnimation = -1;
+    return true;
+}
+
+bool Anim4dcSetAnimationByName(Anim4dcBakedModel *baked, const char *animationName) {
+    if (!baked || !animationName) return false;
+    
+    for (int i = 0; i < baked->animationCount; i++) {
+        if (strcmp(baked->animations[i].name, animationName) == 0) {
+            return Anim4dcSetAnimation(baked, i);
+        }
+    }
+    return false;
+}
+
+bool Anim4dcCrossfadeAnimation(Anim4dcBakedModel *baked, int animationIndex, float fadeDuration) {
+    if (!baked || animationIndex < 0 || animationIndex >= baked->animationCount) {
+        return false;
+    }
+    
+    bool playing = (baked->currentAnimation >= 0 && baked->currentAnimation < baked->animationCount);
+    if (playing && animationIndex == baked->currentAnimation) return true;
+    if (!playing || fadeDuration <= 0.0f) return Anim4dcSetAnimation(baked, animationIndex);
+    
+    // The current animation fades out from where it is, a fade still running is cut short
+    baked->fadeAnimation = baked->currentAnimation;
+    baked->fadeTime = baked->currentTime;
+    baked->fadeKeyframe = baked->currentKeyframe;
+    baked->fadeElapsed = 0.0f;
+    baked->fadeDuration = fadeDuration;
+    
+    baked->currentAnimation = animationIndex;
+    baked->currentTime = 0.0f;
+    baked->currentKeyframe = 0;
+    return true;
+}
+
+bool Anim4dcCrossfadeAnimationByName(Anim4dcBakedModel *baked, const char *animationName, float fadeDuration) {
+    if (!baked || !animationName) return false;
+    
+    for (int i = 0; i < baked->animationCount; i++) {
+        if (strcmp(baked->animations[i].name, animationName) == 0) {
+            return Anim4dcCrossfadeAnimation(baked, i, fadeDuration);
+        }
+    }
+    return false;
+}
+
+int Anim4dcGetCurrentAnimation(const Anim4dcBakedModel *baked) {
+    return baked ? baked->currentAnimation : -1;
+}
+
+int Anim4dcGetAnimationCount(const Anim4dcBakedModel *baked) {
+    return baked ? baked->animationCount : 0;
+}
+
+float Anim4dcGetAnimationTime(const Anim4dcBakedModel *baked) {
+    return baked ? baked->currentTime : 0.0f;
+}
+
+void Anim4dcSetAnimationTime(Anim4dcBakedModel *baked, float time) {
+    if (baked && baked->currentAnimation >= 0 && baked->currentAnimation < baked->animationCount) {
+        float duration = baked->animations[baked->currentAnimation].duration;
+        baked->currentTime = fmod(time, duration);
+        if (baked->currentTime < 0.0f) baked->currentTime += duration;
+    }
+}
+
+void Anim4dcSetAnimationPaused(Anim4dcBakedModel *baked, bool paused) {
+    if (!baked) return;
+    baked->paused = paused;
+}
+
+//------------------------------------------------------------------------------------
+// Batch Rendering and LOD Functions Implementation
+//------------------------------------------------------------------------------------
+
+void Anim4dcUpdateInstanceLOD(Anim4dcBakedModel *baked, Anim4dcModelInstance *instances, int instanceCount, Camera3D camera) {
+    if (!baked || !instances) return;
+    
+    Anim4dcResetLodStats(baked);
+    
+    Anim4dcLodPolicy policy = Anim4dcResolveLodPolicy(baked);
+    Vector4 frustum[6];
+    Anim4dcExtractFrustum(camera, &policy, frustum);
+    Anim4dcPrepareLodLimits(baked, camera);
+    
+    Anim4dcClassifyInstances(baked, instances, NULL, instanceCount, frustum, camera.position);
+}
+
+void Anim4dcUpdateInstanceArraysLOD(Anim4dcBakedModel *baked, Anim4dcInstanceArrays *arrays, Camera3D camera) {
+    if (!baked || !arrays || !arrays->allocation) return;
+    
+    Anim4dcResetLodStats(baked);
+    
+    Anim4dcLodPolicy policy = Anim4dcResolveLodPolicy(baked);
+    Vector4 frustum[6];
+    Anim4dcExtractFrustum(camera, &policy, frustum);
+    Anim4dcPrepareLodLimits(baked, camera);
+    
+    // Capacity is padded to whole batches, the tail past count is classified and ignored
+    for (int first = 0; first < arrays->count; first += ANIM4DC_LOD_BATCH_SIZE) {
+        Anim4dcClassifyLodBatch(baked, &arrays->x[first], &arrays->y[first], &arrays->z[first], &arrays->scale[first],
+                                arrays->count - first, camera.position,
+                                frustum, &arrays->distanceSquared[first], &arrays->lodLevel[first], &arrays->visible[first],
+                                baked->stats.lodTransitions);
+    }
+    Anim4dcCountLodBatch(baked, arrays->lodLevel, arrays->visible, arrays->count);
+}
+
+void Anim4dcUpdateInstanceLODGrid(Anim4dcBakedModel *baked, Anim4dcSpatialGrid *grid, Anim4dcModelInstance *instances, Camera3D camera) {
+    if (!baked || !grid || !instances) return;
+    
+    Anim4dcResetLodStats(baked);
+    
+    Anim4dcLodPolicy policy = Anim4dcResolveLodPolicy(baked);
+    Vector4 frustum[6];
+    Anim4dcExtractFrustum(camera, &policy, frustum);
+    Anim4dcPrepareLodLimits(baked, camera);
+    
+    // States written for another model's bounds no longer hold
+    if (grid->baked != baked) {
+        for (int c = 0; c < grid->cellCount; c++) grid->cells[c].state = -1;
+        grid->baked = baked;
+    }
+    
+    // A cell's instances lie in its bounds, their bounding spheres reach at most padding past them
+    float inset = Vector3Length(baked->boundsCenter) * grid->maxScale;
+    float padding = inset + baked->boundsRadius * grid->maxScale;
+    
+    // Instances of mixed cells queue up for the batch kernel
+    int pending[ANIM4DC_LOD_BATCH_SIZE];
+    int pendingCount = 0;
+    
+    for (int c = 0; c < grid->cellCount; c++) {
+        Anim4dcGridCell *cell = &grid->cells[c];
+        if (cell->count <= 0) continue;
+        
+        // The whole cell lands in one band when its nearest and farthest points are clear of that band's
+        // hysteresis margins (no instance depends on its previous level), a lone instance is cheaper to test directly
+        int state = -1;
+        if (cell->count > 1) {
+            Vector3 boxMin = cell->boundsMin;
+            Vector3 boxMax = cell->boundsMax;
+            float nearest, farthest;
+            Anim4dcBoxDistanceRange(camera.position, boxMin, boxMax, &nearest, &farthest);
+            int lodLevel = Anim4dcGetRangeLodLevel(baked, nearest, farthest, grid->minScale, grid->maxScale);
+            
+            if (lodLevel == ANIM4DC_LOD_CULLED) {
+                state = ANIM4DC_LOD_CULLED * 2;
+            } else if (lodLevel >= 0) {
+                // Fully outside one plane hides every instance, fully inside all of them shows every instance
+                Vector3 center = Vector3Scale(Vector3Add(boxMin, boxMax), 0.5f);
+                float halfDiagonal = Vector3Length(Vector3Subtract(boxMax, center));
+                bool inside = true;
+                bool outside = false;
+                for (int p = 0; p < 6; p++) {
+                    float distance = frustum[p].x * center.x + frustum[p].y * center.y + frustum[p].z * center.z + frustum[p].w;
+                    if (distance < -(halfDiagonal + padding)) outside = true;
+                    if (distance < halfDiagonal + inset) inside = false;
+                }
+                
+                if (outside) state = lodLevel * 2;
+                else if (inside) state = lodLevel * 2 + 1;
+            }
+        }
+        
+        if (state < 0) {
+            for (int i = cell->first; i >= 0; i = grid->next[i]) {
+                pending[pendingCount++] = i;
+                if (pendingCount == ANIM4DC_LOD_BATCH_SIZE) {
+                    Anim4dcClassifyInstances(baked, instances, pending, pendingCount, frustum, camera.position);
+                    pendingCount = 0;
+                }
+            }
+            cell->state = -1;
+            cell->inserted = 0;
+            continue;
+        }
+        
+        // Instances keep what was written last frame while the cell's classification holds, only the
+        // ones inserted since need it (removals may make that count cover a few older ones as well)
+        int writes = (state != cell->state) ? cell->count : cell->inserted;
+        for (int i = cell->first; i >= 0 && writes > 0; i = grid->next[i], writes--) {
+            baked->stats.lodTransitions[state / 2] += ((int)instances[i].lodLevel != state / 2);
+            instances[i].lodLevel = (Anim4dcLodLevel)(state / 2);
+            instances[i].visible = (state % 2 == 1);
+        }
+        cell->state = state;
+        cell->inserted = 0;
+        Anim4dcCountInstances(baked, (Anim4dcLodLevel)(state / 2), (state % 2 == 1), cell->count);
+    }
     
-    if (nextKeyframe == 0) {
-        // Looping case
-        float timeFromStart = anim4dc.currentTime - t1;
-        float totalGap = currentAnim->duration - t1;
-        t = (totalGap > 0.0f) ? (timeFromStart / totalGap) : 0.0f;
-    } else {
-        // Normal case
-        float gap = t2 - t1;
-        t = (gap > 0.0f) ? ((anim4dc.currentTime - t1) / gap) : 0.0f;
+    Anim4dcClassifyInstances(baked, instances, pending, pendingCount, frustum, camera.position);
+}
+
+void Anim4dcRenderInstances(Anim4dcBakedModel *baked, Model model, Anim4dcModelInstance *instances, int instanceCount) {
+    if (!baked || !instances) return;
+    
+    // Without matching meshes there is nothing to animate, just draw
+    if (!Anim4dcCheckModelLayout(baked, model)) {
+        for (int i = 0; i < instanceCount; i++) {
+            if (instances[i].visible) DrawModel(model, instances[i].position, instances[i].scale, WHITE);
+        }
+        return;
     }
     
-    // Clamp interpolation factor
-    t = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+    // Instances following the global animation share its output, uploaded in place when it is the model
+    bool globalUploaded = false;
+    for (int i = 0; i < instanceCount; i++) {
+        Anim4dcModelInstance *instance = &instances[i];
+        bool hasOwnAnimation = (instance->animationIndex >= 0 && instance->animationIndex < baked->animationCount);
+        if (!instance->visible || hasOwnAnimation) continue;
+        
+        if (!globalUploaded) {
+            if (baked->outputMeshes == model.meshes) {
+                for (int r = 0; r < baked->meshCount; r++) {
+                    Mesh *mesh = &model.meshes[baked->meshes[r].meshIndex];
+                    Anim4dcUploadMeshPositions(mesh, mesh->vertices);
+                    baked->stats.meshUploads++;
+                }
+            } else if (baked->outputVertices && baked->outputStride == 3 * sizeof(float)) {
+                Anim4dcUploadModelPositions(baked, &model, baked->outputVertices);
+            } else if (baked->currentAnimation >= 0 && baked->currentAnimation < baked->animationCount) {
+                // Output lives elsewhere (strided buffer, other model): write the global pose in place
+                for (int r = 0; r < baked->meshCount; r++) {
+                    Mesh *mesh = &model.meshes[baked->meshes[r].meshIndex];
+                    Anim4dcWriteGlobalPose(baked, mesh->vertices, 0, baked->meshes[r].vertexOffset, baked->meshes[r].vertexCount);
+                    Anim4dcUploadMeshPositions(mesh, mesh->vertices);
+                    baked->stats.meshUploads++;
+                }
+            }
+            globalUploaded = true;
+        }
+        DrawModel(model, instance->position, instance->scale, WHITE);
+    }
+    
+    // Shared poses: upload each distinct pose once, then draw every instance showing it
+    for (int p = 0; p < ANIM4DC_POSE_CACHE_SIZE; p++) {
+        Anim4dcPoseCacheEntry *entry = &baked->poseCache[p];
+        if (!entry->vertices || entry->animationIndex < 0 || entry->lastUsedFrame != baked->poseFrame) continue;
+        
+        // Poses of a mesh variant are drawn with the variant's model
+        Model poseModel = (entry->meshVariant > 0) ? baked->variants[entry->meshVariant].model : model;
+        bool uploaded = false;
+        for (int i = 0; i < instanceCount; i++) {
+            if (!instances[i].visible || Anim4dcGetInstancePose(baked, &instances[i]) != entry->vertices) continue;
+            
+            if (!uploaded) {
+                Anim4dcUploadPose(baked, &poseModel, Anim4dcGetVariantRanges(baked, entry->meshVariant), entry->vertices);
+                uploaded = true;
+            }
+            DrawModel(poseModel, instances[i].position, instances[i].scale, WHITE);
+        }
+    }
+    
+    // Instances that got no shared pose interpolate straight into the meshes
+    for (int i = 0; i < instanceCount; i++) {
+        Anim4dcModelInstance *instance = &instances[i];
+        if (!instance->visible || Anim4dcGetInstancePose(baked, instance)) continue;
+        
+        if (Anim4dcApplyInstancePose(baked, &model, instance)) {
+            DrawModel(Anim4dcGetInstanceModel(baked, model, instance), instance->position, instance->scale, WHITE);
+        }
+    }
+}
+
+void Anim4dcUploadModelPositions(Anim4dcBakedModel *baked, Model *model, const float *positions) {
+    if (!baked || !model || !positions) return;
+    
+    Anim4dcUploadPose(baked, model, baked->meshes, positions);
+}
+
+bool Anim4dcApplyInstancePose(Anim4dcBakedModel *baked, Model *model, const Anim4dcModelInstance *instance) {
+    if (!baked || !model || !instance || !Anim4dcCheckModelLayout(baked, *model) ||
+        instance->animationIndex < 0 || instance->animationIndex >= baked->animationCount) {
+        return false;
+    }
+    
+    // Mesh variant poses go to the variant's own model
+    int meshVariant = instance->meshVariant;
+    if (meshVariant != 0) {
+        if (meshVariant < 0 || meshVariant >= ANIM4DC_MAX_MESH_VARIANTS || baked->variants[meshVariant].model.meshCount <= 0) return false;
+        model = &baked->variants[meshVariant].model;
+    }
+    const Anim4dcMeshRange *ranges = Anim4dcGetVariantRanges(baked, meshVariant);
+    
+    float *pose = Anim4dcGetInstancePose(baked, instance);
+    if (pose) {
+        Anim4dcUploadPose(baked, model, ranges, pose);
+        return true;
+    }
+    
+    if (!Anim4dcCheckInstanceKeyframes(baked, instance)) return false;
+    
+    // Interpolate (or crossfade) straight into each baked mesh
+    for (int r = 0; r < baked->meshCount; r++) {
+        const Anim4dcMeshRange *range = &ranges[r];
+        Mesh *mesh = &model->meshes[range->meshIndex];
+        
+        Anim4dcWriteInstancePose(baked, instance, mesh->vertices, range->vertexOffset, range->vertexCount);
+        Anim4dcUploadMeshPositions(mesh, mesh->vertices);
+        baked->stats.meshUploads++;
+    }
+    baked->stats.poseVertices += Anim4dcGetVariantVertexCount(baked, meshVariant);
+    return true;
+}
+
+void Anim4dcUploadMeshPositions(Mesh *mesh, const float *positions) {
+    if (!mesh || !mesh->vertices || !positions) return;
+    
+    int dataSize = mesh->vertexCount * 3 * sizeof(float);
+    
+    // Client-array backends (GLdc) draw straight from mesh->vertices
+    if (positions != mesh->vertices) memcpy(mesh->vertices, positions, dataSize);
+    
+    // VBO backends only need the position buffer refreshed, not a full UploadMesh
+    if (mesh->vboId && mesh->vboId[0] != 0) UpdateMeshBuffer(*mesh, 0, mesh->vertices, dataSize, 0);
+}
+
+void Anim4dcUpdateInstances(Anim4dcBakedModel *baked, Anim4dcModelInstance *instances, int instanceCount, float deltaTime) {
+    if (!baked) return;
+    
+    baked->stats.animationUpdates = 0;
+    baked->stats.poseCacheHits = 0;
+    baked->stats.poseCacheMisses = 0;
+    baked->stats.meshUploads = 0;
+    baked->stats.poseVertices = 0;
+    if (!instances) return;
+    
+    baked->poseFrame++;
+    if (baked->poseFrame == 0) baked->poseFrame = 1;    // 0 marks poses never refreshed
+    if (baked->poseQuantum > 0.0f && baked->vertexCount > 0) Anim4dcAllocatePoseCache(baked);
+    
+    for (int i = 0; i < instanceCount; i++) {
+        Anim4dcModelInstance *instance = &instances[i];
+        instance->poseIndex = -1;
+        if (instance->animationIndex < 0 || instance->animationIndex >= baked->animationCount) continue;
+        
+        Anim4dcVertexAnimation *animation = &baked->animations[instance->animationIndex];
+        if (animation->keyframeCount < 1 || animation->duration <= 0.0f) {
+            instance->currentKeyframe = 0;
+            instance->nextKeyframe = 0;
+            instance->blendFactor = 0.0f;
+            continue;
+        }
+        
+        float speed = Anim4dcGetLodSpeed(instance->lodLevel);
+        float step = (speed > 0.0f) ? deltaTime * speed : 0.0f;
+        instance->animationTime = Anim4dcWrapAnimationTime(animation, instance->animationTime + step);
+        
+        // The animation fading out keeps playing on the same clock until the crossfade completes,
+        // the fade itself runs in real time so slowed and frozen instances still finish it
+        bool fading = (instance->fadeDuration > 0.0f);
+        if (fading) {
+            instance->fadeElapsed += deltaTime;
+            if (instance->fadeElapsed >= instance->fadeDuration || instance->fadeAnimation < 0 || 
+                instance->fadeAnimation >= baked->animationCount || baked->animations[instance->fadeAnimation].duration <= 0.0f) {
+                instance->fadeDuration = 0.0f;
+            } else {
+                instance->fadeTime = Anim4dcWrapAnimationTime(&baked->animations[instance->fadeAnimation], instance->fadeTime + step);
+            }
+        }
+        
+        // Poses refresh at the LOD interval, staggered by index so every frame refreshes a similar share;
+        // in between (and when frozen) the instance keeps showing the pose at poseTime.
+        // Hidden instances (distance or frustum culled) only advance their clock
+        int interval = Anim4dcGetLodInterval(instance->lodLevel);
+        // Crossfading instances refresh every frame, up to the one the fade completes in
+        bool refresh = instance->visible &&
+                       (instance->poseFrame == 0 || instance->poseAnimation != instance->animationIndex || fading ||
+                        (interval > 0 && (baked->poseFrame + i) % interval == 0));
+        
+        if (refresh) {
+            instance->poseTime = instance->animationTime;
+            instance->poseAnimation = instance->animationIndex;
+            instance->poseFrame = baked->poseFrame;
+            Anim4dcResolveKeyframes(animation, instance->poseTime, 
+                                    &instance->currentKeyframe, &instance->nextKeyframe, &instance->blendFactor);
+            if (instance->fadeDuration > 0.0f) {
+                Anim4dcResolveKeyframes(&baked->animations[instance->fadeAnimation], instance->fadeTime, 
+                                        &instance->fadeKeyframe, &instance->fadeNextKeyframe, &instance->fadeBlendFactor);
+            }
+            baked->stats.animationUpdates++;
+        }
+        
+        // The LOD level picks the mesh too, a switch keeps the pose time (keyframes match across variants)
+        if (instance->visible) instance->meshVariant = Anim4dcGetLodVariant(baked, instance->lodLevel);
+        
+        // Visible instances at the same animation, mesh and quantized pose time share one pose,
+        // a kept pose finds its cache entry again without interpolating (a crossfaded pose is the instance's own)
+        if (instance->visible && instance->fadeDuration <= 0.0f) {
+            instance->poseIndex = Anim4dcAcquirePose(baked, instance->animationIndex, instance->poseTime, instance->meshVariant);
+        }
+    }
+}
+
+bool Anim4dcCrossfadeInstance(const Anim4dcBakedModel *baked, Anim4dcModelInstance *instance, int animationIndex, float fadeDuration) {
+    if (!baked || !instance || animationIndex < 0 || animationIndex >= baked->animationCount) {
+        return false;
+    }
+    
+    bool playing = (instance->animationIndex >= 0 && instance->animationIndex < baked->animationCount);
+    if (playing && animationIndex == instance->animationIndex) return true;
+    
+    // The displayed pose fades out from where it is, a fade still running is cut short
+    instance->fadeDuration = 0.0f;
+    if (playing && fadeDuration > 0.0f) {
+        instance->fadeAnimation = instance->animationIndex;
+        instance->fadeTime = instance->animationTime;
+        instance->fadeKeyframe = instance->currentKeyframe;
+        instance->fadeNextKeyframe = instance->nextKeyframe;
+        instance->fadeBlendFactor = instance->blendFactor;
+        instance->fadeElapsed = 0.0f;
+        instance->fadeDuration = fadeDuration;
+    }
+    
+    instance->animationIndex = animationIndex;
+    instance->animationTime = 0.0f;
+    instance->currentKeyframe = 0;
+    instance->nextKeyframe = 0;
+    instance->blendFactor = 0.0f;
+    return true;
+}
+
+float *Anim4dcGetInstancePose(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance) {
+    if (!baked || !instance || instance->poseIndex < 0 || 
+        instance->poseIndex >= ANIM4DC_POSE_CACHE_SIZE || baked->poseQuantum <= 0.0f) {
+        return NULL;
+    }
+    
+    // The entry must still hold this instance's key from the current frame
+    const Anim4dcPoseCacheEntry *entry = &baked->poseCache[instance->poseIndex];
+    if (entry->animationIndex != instance->animationIndex || entry->meshVariant != instance->meshVariant || entry->lastUsedFrame != baked->poseFrame ||
+        entry->timeStep != (int)(instance->poseTime / baked->poseQuantum)) {
+        return NULL;
+    }
+    
+    return entry->vertices;
+}
+
+void Anim4dcSetPoseQuantum(Anim4dcBakedModel *baked, float seconds) {
+    if (!baked) return;
+    
+    baked->poseQuantum = (seconds > 0.0f) ? seconds : 0.0f;
+    
+    // Cached keys were computed with the old step
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) baked->poseCache[i].animationIndex = -1;
+    
+    // Without sharing the cache is dead weight, the next update with a step reallocates it
+    if (baked->poseQuantum <= 0.0f && baked->poseCacheVertices) {
+        free(baked->poseCacheVertices);
+        baked->poseCacheVertices = NULL;
+        for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) baked->poseCache[i].vertices = NULL;
+    }
+}
+
+Anim4dcLodPolicy Anim4dcGetDefaultLodPolicy(void) {
+    Anim4dcLodPolicy policy;
+    memset(&policy, 0, sizeof(policy));
+    policy.type = ANIM4DC_LOD_POLICY_DISTANCE;
+    policy.limits[0] = sqrtf(ANIM4DC_LOD_NEAR_DIST2);
+    policy.limits[1] = sqrtf(ANIM4DC_LOD_MID_DIST2);
+    policy.limits[2] = sqrtf(ANIM4DC_LOD_FAR_DIST2);
+    policy.limits[3] = sqrtf(ANIM4DC_LOD_CULL_DIST2);
+    policy.hysteresis[0] = ANIM4DC_LOD_NEAR_HYSTERESIS;
+    policy.hysteresis[1] = ANIM4DC_LOD_MID_HYSTERESIS;
+    policy.hysteresis[2] = ANIM4DC_LOD_FAR_HYSTERESIS;
+    policy.hysteresis[3] = ANIM4DC_LOD_CULL_HYSTERESIS;
+    policy.viewportWidth = 0;
+    policy.viewportHeight = 0;
+    return policy;
+}
+
+Anim4dcLodPolicy Anim4dcGetScreenSizeLodPolicy(int viewportHeight) {
+    Anim4dcLodPolicy policy;
+    memset(&policy, 0, sizeof(policy));
+    policy.type = ANIM4DC_LOD_POLICY_SCREEN_SIZE;
+    policy.limits[0] = ANIM4DC_LOD_NEAR_PIXELS;
+    policy.limits[1] = ANIM4DC_LOD_MID_PIXELS;
+    policy.limits[2] = ANIM4DC_LOD_FAR_PIXELS;
+    policy.limits[3] = ANIM4DC_LOD_CULL_PIXELS;
+    for (int k = 0; k < 4; k++) policy.hysteresis[k] = policy.limits[k] * ANIM4DC_LOD_PIXEL_HYSTERESIS;
+    policy.viewportWidth = 0;
+    policy.viewportHeight = (viewportHeight > 0) ? viewportHeight : 0;
+    return policy;
+}
+
+bool Anim4dcSetLodPolicy(Anim4dcLodPolicy policy) {
+    if (!anim4dc.initialized) {
+        printf("Anim4DC: ERROR - System not initialized\n");
+        return false;
+    }
+    if (!Anim4dcCheckLodPolicy(&policy)) {
+        printf("Anim4DC: ERROR - LOD policy limits must be positive and in band order\n");
+        return false;
+    }
+    
+    anim4dc.lodPolicy = policy;
+    return true;
+}
+
+Anim4dcLodPolicy Anim4dcGetLodPolicy(void) {
+    return anim4dc.initialized ? anim4dc.lodPolicy : Anim4dcGetDefaultLodPolicy();
+}
+
+bool Anim4dcSetModelLodPolicy(Anim4dcBakedModel *baked, const Anim4dcLodPolicy *policy) {
+    if (!baked) return false;
+    
+    if (!policy) {
+        baked->hasLodPolicy = false;
+        return true;
+    }
+    if (!Anim4dcCheckLodPolicy(policy)) {
+        printf("Anim4DC: ERROR - LOD policy limits must be positive and in band order\n");
+        return false;
+    }
+    
+    baked->lodPolicy = *policy;
+    baked->hasLodPolicy = true;
+    return true;
+}
+
+void Anim4dcSetLodHysteresis(Anim4dcBakedModel *baked, float nearMargin, float midMargin, float farMargin, float cullMargin) {
+    if (!baked) return;
+    
+    if (!baked->hasLodPolicy) {
+        baked->lodPolicy = Anim4dcGetLodPolicy();
+        baked->hasLodPolicy = true;
+    }
+    baked->lodPolicy.hysteresis[0] = (nearMargin > 0.0f) ? nearMargin : 0.0f;
+    baked->lodPolicy.hysteresis[1] = (midMargin > 0.0f) ? midMargin : 0.0f;
+    baked->lodPolicy.hysteresis[2] = (farMargin > 0.0f) ? farMargin : 0.0f;
+    baked->lodPolicy.hysteresis[3] = (cullMargin > 0.0f) ? cullMargin : 0.0f;
+}
+
+bool Anim4dcInterpolateInstance(const Anim4dcBakedModel *baked, const Anim4dcModelInstance *instance, float *output) {
+    if (!baked || !instance || !output || 
+        instance->animationIndex < 0 || instance->animationIndex >= baked->animationCount ||
+        instance->meshVariant < 0 || instance->meshVariant >= ANIM4DC_MAX_MESH_VARIANTS || 
+        (instance->meshVariant > 0 && baked->variants[instance->meshVariant].vertexCount <= 0)) {
+        return false;
+    }
     
-    // Interpolate vertices
-    Anim4dcInterpolateVertices(
-        anim4dc.interpolationBuffer,
-        currentAnim->keyframes[currentKeyframe].vertices,
-        currentAnim->keyframes[nextKeyframe].vertices,
-        t,
-        anim4dc.vertexCount
-    );
+    if (!Anim4dcCheckInstanceKeyframes(baked, instance)) return false;
+    
+    Anim4dcWriteInstancePose(baked, instance, output, 0, Anim4dcGetVariantVertexCount(baked, instance->meshVariant));
+    return true;
 }
 
-float *Anim4dcGetInterpolatedVertices(void) {
-    return anim4dc.interpolationBuffer;
+Anim4dcStats Anim4dcGetStats(const Anim4dcBakedModel *baked) {
+    if (!baked) {
+        Anim4dcStats empty = { 0 };
+        return empty;
+    }
+    
+    return baked->stats;
 }
 
 //------------------------------------------------------------------------------------
-// Animation Control Functions Implementation
+// Mesh Variant Functions Implementation
 //------------------------------------------------------------------------------------
 
-bool Anim4dcSetAnimation(int animationIndex) {
-    if (!anim4dc.initialized || animationIndex < 0 || animationIndex >= anim4dc.animationCount) {
+bool Anim4dcLoadMeshVariants(Anim4dcBakedModel *baked, Model model) {
+    if (!baked || !Anim4dcCheckModelLayout(baked, model)) {
+        printf("Anim4DC: ERROR - Model does not match the baked meshes, cannot load mesh variants\n");
+        return false;
+    }
+    
+    Anim4dcUnloadMeshVariants(baked);
+    
+    int loaded = 0;
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        Anim4dcMeshVariant *variant = &baked->variants[v];
+        if (variant->vertexCount <= 0) continue;
+        
+        // Same materials, transform and static meshes, own copies of the decimated meshes
+        Model *variantModel = &variant->model;
+        *variantModel = model;
+        variantModel->meshes = (Mesh*)MemAlloc(model.meshCount * sizeof(Mesh));
+        variantModel->meshMaterial = (int*)MemAlloc(model.meshCount * sizeof(int));
+        variantModel->boneCount = 0;
+        variantModel->bones = NULL;
+        variantModel->bindPose = NULL;
+        
+        bool success = (variantModel->meshes && variantModel->meshMaterial);
+        if (success) {
+            memcpy(variantModel->meshes, model.meshes, model.meshCount * sizeof(Mesh));
+            if (model.meshMaterial) memcpy(variantModel->meshMaterial, model.meshMaterial, model.meshCount * sizeof(int));
+            for (int r = 0; r < baked->meshCount; r++) memset(&variantModel->meshes[baked->meshes[r].meshIndex], 0, sizeof(Mesh));
+        }
+        
+        const unsigned short *indices = variant->indices;
+        for (int r = 0; r < baked->meshCount && success; r++) {
+            int meshIndex = baked->meshes[r].meshIndex;
+            success = Anim4dcBuildVariantMesh(variant, r, &baked->meshes[r], &model.meshes[meshIndex], indices, &variantModel->meshes[meshIndex]);
+            indices += variant->indexCounts[r];
+        }
+        
+        if (!success) {
+            printf("Anim4DC: ERROR - Failed to build the LOD %d mesh variant model\n", v);
+            Anim4dcFreeVariantModel(baked, variantModel);
+            Anim4dcUnloadMeshVariants(baked);
+            return false;
+        }
+        loaded++;
+    }
+    
+    if (loaded == 0) {
+        printf("Anim4DC: No mesh variants baked, instances keep the full resolution meshes\n");
         return false;
     }
     
-    anim4dc.currentAnimation = animationIndex;
-    anim4dc.currentTime = 0.0f;
+    printf("Anim4DC: Loaded %d mesh variants\n", loaded);
     return true;
 }
 
-bool Anim4dcSetAnimationByName(const char *animationName) {
-    if (!anim4dc.initialized || !animationName) return false;
+void Anim4dcUnloadMeshVariants(Anim4dcBakedModel *baked) {
+    if (!baked) return;
     
-    for (int i = 0; i < anim4dc.animationCount; i++) {
-        if (strcmp(anim4dc.animations[i].name, animationName) == 0) {
-            return Anim4dcSetAnimation(i);
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        if (baked->variants[v].model.meshes) Anim4dcFreeVariantModel(baked, &baked->variants[v].model);
+    }
+    
+    // Poses cached for a variant have no model left to show them
+    for (int i = 0; i < ANIM4DC_POSE_CACHE_SIZE; i++) {
+        if (baked->poseCache[i].meshVariant > 0) {
+            baked->poseCache[i].animationIndex = -1;
+            baked->poseCache[i].meshVariant = 0;
         }
     }
-    return false;
 }
 
-int Anim4dcGetCurrentAnimation(void) {
-    return anim4dc.currentAnimation;
+Model Anim4dcGetInstanceModel(const Anim4dcBakedModel *baked, Model model, const Anim4dcModelInstance *instance) {
+    if (!baked || !instance || instance->meshVariant <= 0 || instance->meshVariant >= ANIM4DC_MAX_MESH_VARIANTS ||
+        baked->variants[instance->meshVariant].model.meshCount <= 0) {
+        return model;
+    }
+    
+    return baked->variants[instance->meshVariant].model;
+}
+
+int Anim4dcGetLodVertexCount(const Anim4dcBakedModel *baked, Anim4dcLodLevel level) {
+    if (!baked) return 0;
+    
+    int variant = ((int)level < ANIM4DC_MAX_MESH_VARIANTS) ? (int)level : ANIM4DC_MAX_MESH_VARIANTS - 1;
+    while (variant > 0 && baked->variants[variant].vertexCount <= 0) variant--;
+    
+    return Anim4dcGetVariantVertexCount(baked, variant);
+}
+
+//------------------------------------------------------------------------------------
+// Instance Arrays Functions Implementation
+//------------------------------------------------------------------------------------
+
+Anim4dcInstanceArrays Anim4dcCreateInstanceArrays(int capacity) {
+    Anim4dcInstanceArrays arrays = { 0 };
+    if (capacity <= 0) {
+        printf("Anim4DC: ERROR - Instance arrays need room for at least one instance\n");
+        return arrays;
+    }
+    
+    // Every array starts on its own aligned boundary inside one block and holds whole LOD batches
+    int padded = (capacity + ANIM4DC_LOD_BATCH_SIZE - 1) / ANIM4DC_LOD_BATCH_SIZE * ANIM4DC_LOD_BATCH_SIZE;
+    uint32_t floatBytes = Anim4dcAlignOffset(padded * sizeof(float));
+    uint32_t byteBytes = Anim4dcAlignOffset(padded);
+    arrays.allocation = malloc(ANIM4DC_BAKED_ALIGNMENT + 5 * floatBytes + 2 * byteBytes);
+    if (!arrays.allocation) {
+        printf("Anim4DC: ERROR - Failed to allocate instance arrays for %d instances\n", capacity);
+        return arrays;
+    }
+    
+    unsigned char *base = Anim4dcArenaBase(arrays.allocation);
+    arrays.x = (float*)base;
+    arrays.y = (float*)(base + floatBytes);
+    arrays.z = (float*)(base + 2 * floatBytes);
+    arrays.scale = (float*)(base + 3 * floatBytes);
+    arrays.distanceSquared = (float*)(base + 4 * floatBytes);
+    arrays.lodLevel = base + 5 * floatBytes;
+    arrays.visible = base + 5 * floatBytes + byteBytes;
+    arrays.capacity = capacity;
+    
+    memset(base, 0, 5 * floatBytes + 2 * byteBytes);
+    for (int i = 0; i < padded; i++) arrays.scale[i] = 1.0f;
+    return arrays;
 }
 
-float Anim4dcGetAnimationTime(void) {
-    return anim4dc.currentTime;
+void Anim4dcUnloadInstanceArrays(Anim4dcInstanceArrays arrays) {
+    free(arrays.allocation);
 }
 
-void Anim4dcSetAnimationTime(float time) {
-    if (anim4dc.currentAnimation >= 0 && anim4dc.currentAnimation < anim4dc.animationCount) {
-        float duration = anim4dc.animations[anim4dc.currentAnimation].duration;
-        anim4dc.currentTime = fmod(time, duration);
-        if (anim4dc.currentTime < 0.0f) anim4dc.currentTime += duration;
+bool Anim4dcLoadInstanceArraysFrom(Anim4dcInstanceArrays *arrays, const Anim4dcModelInstance *instances, int count) {
+    if (!arrays || !arrays->allocation || !instances || count < 0) return false;
+    if (count > arrays->capacity) {
+        printf("Anim4DC: ERROR - %d instances exceed the instance arrays' %d\n", count, arrays->capacity);
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        arrays->x[i] = instances[i].position.x;
+        arrays->y[i] = instances[i].position.y;
+        arrays->z[i] = instances[i].position.z;
+        arrays->scale[i] = instances[i].scale;
+        arrays->lodLevel[i] = (unsigned char)instances[i].lodLevel;
     }
+    arrays->count = count;
+    
+    return true;
 }
 
-void Anim4dcSetAnimationPaused(bool paused) {
-    // This would require additional state tracking - left as exercise
-    // Could add a 'paused' field to the animation system
+void Anim4dcCopyInstanceArraysLOD(const Anim4dcInstanceArrays *arrays, Anim4dcModelInstance *instances) {
+    if (!arrays || !arrays->allocation || !instances) return;
+    
+    for (int i = 0; i < arrays->count; i++) {
+        instances[i].distanceSquared = arrays->distanceSquared[i];
+        instances[i].lodLevel = (Anim4dcLodLevel)arrays->lodLevel[i];
+        instances[i].visible = (arrays->visible[i] != 0);
+    }
 }
 
 //------------------------------------------------------------------------------------
-// Batch Rendering and LOD Functions Implementation
+// Spatial Grid Functions Implementation
 //------------------------------------------------------------------------------------
 
-void Anim4dcUpdateInstanceLOD(Anim4dcModelInstance *instances, int instanceCount, Vector3 cameraPosition) {
-    anim4dc_stats.visibleInstances = 0;
-    anim4dc_stats.culledInstances = 0;
+Anim4dcSpatialGrid *Anim4dcCreateSpatialGrid(float cellSize, int maxInstances) {
+    if (maxInstances <= 0) {
+        printf("Anim4DC: ERROR - Spatial grid needs room for at least one instance\n");
+        return NULL;
+    }
     
-    for (int i = 0; i < instanceCount; i++) {
-        Anim4dcModelInstance *instance = &instances[i];
-        
-        // Calculate squared distance to avoid sqrt
-        Vector3 diff = Vector3Subtract(instance->position, cameraPosition);
-        instance->distanceSquared = Vector3LengthSqr(diff);
-        
-        // Determine LOD level
-        if (instance->distanceSquared > ANIM4DC_LOD_CULL_DIST2) {
-            instance->lodLevel = ANIM4DC_LOD_CULLED;
-            instance->visible = false;
-            anim4dc_stats.culledInstances++;
-        } else if (instance->distanceSquared > ANIM4DC_LOD_FAR_DIST2) {
-            instance->lodLevel = ANIM4DC_LOD_FAR;
-            instance->visible = true;
-            anim4dc_stats.visibleInstances++;
-        } else if (instance->distanceSquared > ANIM4DC_LOD_MID_DIST2) {
-            instance->lodLevel = ANIM4DC_LOD_MID;
-            instance->visible = true;
-            anim4dc_stats.visibleInstances++;
-        } else {
-            instance->lodLevel = ANIM4DC_LOD_NEAR;
-            instance->visible = true;
-            anim4dc_stats.visibleInstances++;
-        }
+    Anim4dcSpatialGrid *grid = (Anim4dcSpatialGrid*)calloc(1, sizeof(Anim4dcSpatialGrid));
+    if (!grid) {
+        printf("Anim4DC: ERROR - Failed to allocate spatial grid\n");
+        return NULL;
+    }
+    
+    // Occupied cells never outnumber instances, so twice the instances keeps a rebuilt table half empty
+    grid->cellSize = (cellSize > 0.0f) ? cellSize : ANIM4DC_GRID_CELL_SIZE;
+    grid->tableSize = 16;
+    while (grid->tableSize < maxInstances * 2) grid->tableSize *= 2;
+    grid->maxInstances = maxInstances;
+    
+    grid->table = (int*)malloc(grid->tableSize * sizeof(int));
+    grid->cells = (Anim4dcGridCell*)malloc((int)(grid->tableSize * ANIM4DC_GRID_MAX_LOAD) * sizeof(Anim4dcGridCell));
+    grid->instanceCell = (int*)malloc(maxInstances * sizeof(int));
+    grid->next = (int*)malloc(maxInstances * sizeof(int));
+    grid->previous = (int*)malloc(maxInstances * sizeof(int));
+    if (!grid->table || !grid->cells || !grid->instanceCell || !grid->next || !grid->previous) {
+        printf("Anim4DC: ERROR - Failed to allocate spatial grid for %d instances\n", maxInstances);
+        Anim4dcUnloadSpatialGrid(grid);
+        return NULL;
     }
+    
+    Anim4dcClearSpatialGrid(grid);
+    return grid;
 }
 
-void Anim4dcRenderInstances(Model model, Anim4dcModelInstance *instances, int instanceCount) {
-    // This would render all visible instances with their respective transformations
-    // Implementation depends on specific rendering needs
-    for (int i = 0; i < instanceCount; i++) {
-        if (instances[i].visible) {
-            // Apply vertex animation if available
-            if (anim4dc.interpolationBuffer && model.meshCount > 0) {
-                // Update mesh vertices with interpolated data
-                memcpy(model.meshes[0].vertices, anim4dc.interpolationBuffer, 
-                       anim4dc.vertexCount * 3 * sizeof(float));
-                UploadMesh(&model.meshes[0], false);
-            }
-            
-            DrawModel(model, instances[i].position, instances[i].scale, WHITE);
+void Anim4dcUnloadSpatialGrid(Anim4dcSpatialGrid *grid) {
+    if (!grid) return;
+    
+    free(grid->table);
+    free(grid->cells);
+    free(grid->instanceCell);
+    free(grid->next);
+    free(grid->previous);
+    free(grid);
+}
+
+bool Anim4dcBuildSpatialGrid(Anim4dcSpatialGrid *grid, const Anim4dcModelInstance *instances, int instanceCount) {
+    if (!grid || !instances || instanceCount < 0) return false;
+    if (instanceCount > grid->maxInstances) {
+        printf("Anim4DC: ERROR - %d instances exceed the spatial grid's %d\n", instanceCount, grid->maxInstances);
+        return false;
+    }
+    
+    Anim4dcClearSpatialGrid(grid);
+    for (int i = 0; i < instanceCount; i++) Anim4dcInsertGridInstance(grid, &instances[i], i);
+    grid->instanceCount = instanceCount;
+    
+    return true;
+}
+
+bool Anim4dcMoveGridInstance(Anim4dcSpatialGrid *grid, const Anim4dcModelInstance *instances, int index) {
+    if (!grid || !instances || index < 0 || index > grid->instanceCount || index >= grid->maxInstances) return false;
+    
+    const Anim4dcModelInstance *instance = &instances[index];
+    if (fabsf(instance->scale) > grid->maxScale) grid->maxScale = fabsf(instance->scale);
+    
+    // Still in the same cell: nothing to relink, the cell bounds grow to the new position
+    int cellIndex = grid->instanceCell[index];
+    if (cellIndex >= 0) {
+        int x, y, z;
+        Anim4dcGetGridCoords(grid, instance->position, &x, &y, &z);
+        Anim4dcGridCell *cell = &grid->cells[cellIndex];
+        if (cell->x == x && cell->y == y && cell->z == z) {
+            cell->boundsMin = Vector3Min(cell->boundsMin, instance->position);
+            cell->boundsMax = Vector3Max(cell->boundsMax, instance->position);
+            return true;
         }
     }
+    
+    Anim4dcRemoveGridInstance(grid, index);
+    if (index == grid->instanceCount) grid->instanceCount++;
+    
+    // Emptied cells pile up as instances wander, rebuilding drops them
+    if (grid->cellCount >= (int)(grid->tableSize * ANIM4DC_GRID_MAX_LOAD)) {
+        return Anim4dcBuildSpatialGrid(grid, instances, grid->instanceCount);
+    }
+    
+    Anim4dcInsertGridInstance(grid, instance, index);
+    return true;
+}
+
+int Anim4dcGetSpatialGridCellCount(const Anim4dcSpatialGrid *grid) {
+    return grid ? grid->occupiedCells : 0;
+}
+
+//------------------------------------------------------------------------------------
+// Interpolation Kernel Functions Implementation
+//------------------------------------------------------------------------------------
+
+bool Anim4dcIsKernelSupported(Anim4dcKernel kernel) {
+    if (kernel < 0 || kernel >= ANIM4DC_KERNEL_COUNT || !anim4dcKernels[kernel]) return false;
+    
+#if defined(ANIM4DC_X86_KERNELS)
+    if (kernel == ANIM4DC_KERNEL_SSE) return __builtin_cpu_supports("sse");
+    if (kernel == ANIM4DC_KERNEL_AVX) return __builtin_cpu_supports("avx");
+#endif
+    
+    return true;
+}
+
+bool Anim4dcSetKernel(Anim4dcKernel kernel) {
+    if (!Anim4dcIsKernelSupported(kernel)) return false;
+    
+    anim4dc.kernel = kernel;
+    return true;
+}
+
+Anim4dcKernel Anim4dcGetKernel(void) {
+    return anim4dc.kernel;
 }
 
-Anim4dcStats Anim4dcGetStats(void) {
-    return anim4dc_stats;
+const char *Anim4dcGetKernelName(Anim4dcKernel kernel) {
+    return (kernel >= 0 && kernel < ANIM4DC_KERNEL_COUNT) ? anim4dcKernelNames[kernel] : "unknown";
+}
+
+bool Anim4dcValidateKernels(void) {
+    // Odd vertex count exercises the vector tails, the 32 byte stride leaves gaps that must stay untouched
+    #define ANIM4DC_VALIDATE_VERTICES   67
+    #define ANIM4DC_VALIDATE_FLOATS     (ANIM4DC_VALIDATE_VERTICES * 8)
+    static const float blends[] = { 0.0f, 0.125f, 0.5f, 0.7071f, 1.0f };
+    static const int strides[] = { 3 * sizeof(float), 8 * sizeof(float) };
+    
+    float vertices1[ANIM4DC_VALIDATE_VERTICES * 3];
+    float vertices2[ANIM4DC_VALIDATE_VERTICES * 3];
+    float expected[ANIM4DC_VALIDATE_FLOATS];
+    float actual[ANIM4DC_VALIDATE_FLOATS];
+    
+    // Mixed magnitudes and signs, like model space positions
+    for (int i = 0; i < ANIM4DC_VALIDATE_VERTICES * 3; i++) {
+        vertices1[i] = sinf(i * 0.37f) * (float)(1 << (i % 10));
+        vertices2[i] = cosf(i * 0.91f) * (float)(1 << (i % 7)) - vertices1[i] * 0.5f;
+    }
+    
+    bool valid = true;
+    
+    for (int kernel = 0; kernel < ANIM4DC_KERNEL_COUNT; kernel++) {
+        if (!Anim4dcIsKernelSupported((Anim4dcKernel)kernel)) continue;
+        
+        float worst = 0.0f;
+        bool passed = true;
+        
+        for (int s = 0; s < (int)(sizeof(strides) / sizeof(strides[0])); s++) {
+            for (int b = 0; b < (int)(sizeof(blends) / sizeof(blends[0])); b++) {
+                for (int i = 0; i < ANIM4DC_VALIDATE_FLOATS; i++) expected[i] = actual[i] = -12345.0f;
+                
+                Anim4dcLerpScalar(expected, strides[s], vertices1, vertices2, blends[b], ANIM4DC_VALIDATE_VERTICES);
+                anim4dcKernels[kernel](actual, strides[s], vertices1, vertices2, blends[b], ANIM4DC_VALIDATE_VERTICES);
+                
+                // In place into the first source, as source frame resampling does
+                if (strides[s] == 3 * sizeof(float)) {
+                    float inPlace[ANIM4DC_VALIDATE_VERTICES * 3];
+                    memcpy(inPlace, vertices1, sizeof(inPlace));
+                    anim4dcKernels[kernel](inPlace, strides[s], inPlace, vertices2, blends[b], ANIM4DC_VALIDATE_VERTICES);
+                    if (memcmp(inPlace, actual, sizeof(inPlace)) != 0) passed = false;
+                }
+                
+                for (int i = 0; i < ANIM4DC_VALIDATE_FLOATS; i++) {
+                    float deviation = fabsf(actual[i] - expected[i]);
+                    if (!(deviation <= ANIM4DC_KERNEL_EPSILON * fmaxf(1.0f, fabsf(expected[i])))) passed = false;
+                    if (deviation > worst) worst = deviation;
+                }
+            }
+        }
+        
+        printf("Anim4DC: %s kernel max deviation %g (%s)\n", anim4dcKernelNames[kernel], worst, passed ? "ok" : "FAILED");
+        if (!passed) valid = false;
+    }
+    
+    #undef ANIM4DC_VALIDATE_VERTICES
+    #undef ANIM4DC_VALIDATE_FLOATS
+    return valid;
 }
 
 //------------------------------------------------------------------------------------
@@ -621,26 +6130,78 @@ Model Anim4dcLoadModel(const char *basePath) {
     return model;
 }
 
-int Anim4dcCalculateMemoryUsage(void) {
+int Anim4dcCalculateMemoryUsage(const Anim4dcBakedModel *baked) {
+    if (!baked) return 0;
+    
     int totalMemory = 0;
     
-    // Calculate keyframe memory
-    for (int a = 0; a < anim4dc.animationCount; a++) {
-        for (int k = 0; k < anim4dc.animations[a].keyframeCount; k++) {
-            if (anim4dc.animations[a].keyframes[k].vertices) {
-                totalMemory += anim4dc.animations[a].keyframes[k].vertexCount * 3 * sizeof(float);
+    // Calculate keyframe memory (quantized keyframes take their compressed size)
+    totalMemory += baked->animationCount * sizeof(Anim4dcVertexAnimation);
+    for (int a = 0; a < baked->animationCount; a++) {
+        totalMemory += baked->animations[a].keyframeCount * sizeof(Anim4dcVertexKeyframe);
+        for (int k = 0; k < baked->animations[a].keyframeCount; k++) {
+            const Anim4dcVertexKeyframe *keyframe = &baked->animations[a].keyframes[k];
+            if (keyframe->vertices) {
+                totalMemory += keyframe->vertexCount * 3 * sizeof(float);
+            } else if (keyframe->quantized) {
+                totalMemory += keyframe->vertexCount * 3 * sizeof(short);
             }
         }
     }
     
-    // Add interpolation buffer
-    if (anim4dc.interpolationBuffer) {
-        totalMemory += anim4dc.vertexCount * 3 * sizeof(float);
+    // Add the rest pose and moving vertex lists of sparse animations
+    if (baked->restPose) {
+        totalMemory += baked->vertexCount * 3 * sizeof(float);
+        for (int a = 0; a < baked->animationCount; a++) totalMemory += baked->animations[a].movingCount * sizeof(uint32_t);
+    }
+    
+    // Add the basis shapes and weights of basis compressed animations
+    for (int a = 0; a < baked->animationCount; a++) {
+        if (baked->animations[a].basis) totalMemory += Anim4dcAnimationDataSize(baked->storage, &baked->animations[a]);
+    }
+    
+    // Add the segment lists and transforms of rigid animations (basis compressed ones counted their transforms above)
+    for (int a = 0; a < baked->animationCount; a++) {
+        const Anim4dcVertexAnimation *animation = &baked->animations[a];
+        if (!animation->segmentStarts) continue;
+        
+        totalMemory += Anim4dcSegmentListSize(animation);
+        if (!animation->basis) totalMemory += animation->keyframeCount * animation->segmentCount * 12 * sizeof(float);
+    }
+    
+    // Add mesh variants: keyframes, source vertices and indices
+    for (int v = 1; v < ANIM4DC_MAX_MESH_VARIANTS; v++) {
+        const Anim4dcMeshVariant *variant = &baked->variants[v];
+        if (variant->vertexCount <= 0) continue;
+        
+        for (int a = 0; a < baked->animationCount; a++) {
+            totalMemory += baked->animations[a].keyframeCount * 
+                           (sizeof(Anim4dcVertexKeyframe) + Anim4dcKeyframeDataSize(baked->storage, variant->vertexCount));
+        }
+        totalMemory += variant->vertexCount * sizeof(uint32_t) + variant->indexCount * sizeof(unsigned short);
+    }
+    
+    // Add interpolation buffer (none while interpolating into a registered destination)
+    if (baked->interpolationBuffer) {
+        totalMemory += baked->vertexCount * 3 * sizeof(float);
+    }
+    
+    // Add pose cache
+    if (baked->poseCacheVertices) {
+        totalMemory += ANIM4DC_POSE_CACHE_SIZE * baked->vertexCount * 3 * sizeof(float);
     }
     
     return totalMemory / 1024;  // Convert to KB
 }
 
+int Anim4dcGetTotalMemoryUsage(void) {
+    int totalMemory = 0;
+    for (Anim4dcBakedModel *baked = anim4dc.models; baked; baked = baked->next) {
+        totalMemory += Anim4dcCalculateMemoryUsage(baked);
+    }
+    return totalMemory;
+}
+
 const char *Anim4dcGetVersion(void) {
     return ANIM4DC_VERSION;
 }
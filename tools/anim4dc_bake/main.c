@@ -0,0 +1,143 @@
+/**********************************************************************************************
+*
+*   anim4dc_bake - Offline Vertex Animation Baker
+*
+*   Host-side tool that bakes a skinned model's skeletal animations into a .a4d file.
+*   The Dreamcast loads the result with Anim4dcLoadBaked() in one read: no glTF
+*   animation parsing and no skinning at boot.
+*
+*   USAGE:
+*       anim4dc_bake <model.gltf|glb|iqm> <output.a4d> [options]
+*
+*   OPTIONS:
+*       --max-error <units>   Adaptive keyframe selection with the given max per-vertex
+*                             position error (default: fixed 4/8 frame stride)
+*       --storage <mode>      float (default), int16 (box per animation) or
+*                             int16-keyframe (box per keyframe)
+*       --fps <rate>          Resample clips to this rate before keyframe selection, fixed
+*                             stride then keeps one keyframe per sample
+*       --source-fps <rate>   Rate the model's animation frames were sampled at
+*                             (default: 1000/17 for glTF, the file's rate for IQM)
+*       --weld                Weld duplicate vertices, index and cache order the meshes, so
+*                             keyframes store unique vertices only (load the model with
+*                             Anim4dcMatchModelLayout() at runtime)
+*       --lod-vertices <mid,far,frozen>
+*                             Bake decimated meshes with about these vertex counts for the
+*                             MID, FAR and FROZEN LOD levels (0 = no mesh for the level)
+*       --static-threshold <units>
+*                             Drop vertices that stay this close to the bind pose for a whole
+*                             clip from its keyframes, the rest are stored as deltas
+*       --basis-error <units> Store each animation as a mean and the fewest basis shapes that
+*                             rebuild its keyframes within this error, plus per keyframe weights
+*       --rigid-error <units> Store vertices that follow one bone within this error as one 3x4
+*                             transform per rigid segment and keyframe, the rest as deltas
+*
+**********************************************************************************************/
+
+#define ANIM4DC_IMPLEMENTATION
+#include "anim4dc.h"
+
+static void PrintUsage(const char *program) {
+    printf("Usage: %s <model.gltf|glb|iqm> <output.a4d> [--max-error <units>] [--storage float|int16|int16-keyframe]\n"
+           "       [--fps <rate>] [--source-fps <rate>] [--weld] [--lod-vertices <mid,far,frozen>]\n"
+           "       [--static-threshold <units>] [--basis-error <units>] [--rigid-error <units>]\n", program);
+}
+
+static bool ParseStorageMode(const char *text, Anim4dcStorageMode *storage) {
+    if (strcmp(text, "float") == 0) *storage = ANIM4DC_STORAGE_FLOAT;
+    else if (strcmp(text, "int16") == 0) *storage = ANIM4DC_STORAGE_INT16_ANIMATION;
+    else if (strcmp(text, "int16-keyframe") == 0) *storage = ANIM4DC_STORAGE_INT16_KEYFRAME;
+    else return false;
+    
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    const char *modelPath = argv[1];
+    const char *outputPath = argv[2];
+    Anim4dcBakeOptions options = Anim4dcGetDefaultBakeOptions();
+    options.sourceFrameRate = Anim4dcGetSourceFrameRate(modelPath);
+    
+    for (int i = 3; i < argc; i++) {
+        if ((strcmp(argv[i], "--max-error") == 0) && (i + 1 < argc)) {
+            options.maxError = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc)) {
+            options.targetFrameRate = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--source-fps") == 0) && (i + 1 < argc)) {
+            options.sourceFrameRate = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--static-threshold") == 0) && (i + 1 < argc)) {
+            options.staticThreshold = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--basis-error") == 0) && (i + 1 < argc)) {
+            options.basisMaxError = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--rigid-error") == 0) && (i + 1 < argc)) {
+            options.rigidMaxError = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--weld") == 0) {
+            options.weldVertices = true;
+        } else if ((strcmp(argv[i], "--lod-vertices") == 0) && (i + 1 < argc) &&
+                   (sscanf(argv[i + 1], "%d,%d,%d", &options.lodVertexCounts[0], &options.lodVertexCounts[1], &options.lodVertexCounts[2]) == 3)) {
+            i++;
+        } else if ((strcmp(argv[i], "--storage") == 0) && (i + 1 < argc) && ParseStorageMode(argv[i + 1], &options.storage)) {
+            i++;
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    // raylib uploads meshes on load, so a (hidden) GL context is required
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "anim4dc_bake");
+    
+    int result = 1;
+    Model model = LoadModel(modelPath);
+    int animationCount = 0;
+    ModelAnimation *animations = LoadModelAnimations(modelPath, &animationCount);
+    
+    if (model.meshCount > 0 && animationCount > 0 && Anim4dcInit()) {
+        Anim4dcBakeReport *reports = (Anim4dcBakeReport *)calloc(animationCount, sizeof(Anim4dcBakeReport));
+        
+        // Always measure so the report shows what the chosen settings cost
+        Anim4dcBakedModel *baked = reports ? Anim4dcBakeVertexAnimationsEx(model, animations, animationCount, options, reports) : NULL;
+        if (baked && Anim4dcSaveBaked(baked, outputPath)) {
+            printf("\nSource %.2f fps, keyframes selected at %.2f fps\n", options.sourceFrameRate,
+                   (options.targetFrameRate > 0.0f) ? options.targetFrameRate : options.sourceFrameRate);
+            printf("%-12s %8s %9s %10s %10s %10s %8s %6s %10s %9s %10s %8s\n", "Animation", "Frames", "Duration", "Keyframes", "MaxError",
+                   "QuantError", "Moving", "Basis", "BasisError", "Segments", "RigidError", "KB");
+            for (int a = 0; a < animationCount; a++) {
+                printf("%-12d %8d %8.2fs %10d %10.4f %10.4f %8d %6d %10.4f %9d %10.4f %8d\n", a, reports[a].sourceFrames, reports[a].duration,
+                       reports[a].keyframeCount, reports[a].maxError, reports[a].quantizationError, reports[a].movingVertices,
+                       reports[a].basisShapes, reports[a].basisError, reports[a].rigidSegments, reports[a].rigidError, 
+                       reports[a].keyframeBytes/1024);
+            }
+            // Basis playback rebuilds each coordinate with K multiply-adds instead of one lerp
+            for (int a = 0; a < animationCount; a++) {
+                if (reports[a].basisShapes > 0) {
+                    printf("Animation %d: %d multiply-adds per moving vertex (dense: 3 lerps)\n", a, 3*reports[a].basisShapes);
+                }
+            }
+            printf("Mesh vertices: NEAR %d, MID %d, FAR %d, FROZEN %d\n", Anim4dcGetLodVertexCount(baked, ANIM4DC_LOD_NEAR),
+                   Anim4dcGetLodVertexCount(baked, ANIM4DC_LOD_MID), Anim4dcGetLodVertexCount(baked, ANIM4DC_LOD_FAR),
+                   Anim4dcGetLodVertexCount(baked, ANIM4DC_LOD_FROZEN));
+            printf("Keyframe memory: %d KB\n", Anim4dcCalculateMemoryUsage(baked));
+            result = 0;
+        }
+        
+        Anim4dcUnloadBakedModel(baked);
+        free(reports);
+        Anim4dcShutdown();
+    } else {
+        printf("anim4dc_bake: %s has no meshes or animations\n", modelPath);
+    }
+    
+    if (animationCount > 0) UnloadModelAnimations(animations, animationCount);
+    UnloadModel(model);
+    CloseWindow();
+    
+    return result;
+}
@@ -0,0 +1,228 @@
+/**********************************************************************************************
+*
+*   anim4dc_bench - LOD Classification Benchmark
+*
+*   Host-side tool that times Anim4dcUpdateInstanceLOD() (linear scan) against
+*   Anim4dcUpdateInstanceArraysLOD() (structure-of-arrays scan) and Anim4dcUpdateInstanceLODGrid()
+*   (spatial grid) on crowds of 100, 1k and 10k instances wandering around a field while the
+*   camera orbits it, and checks all three agree. LOD churn (instances changing level per frame)
+*   shows what the hysteresis margins save.
+*
+*   USAGE:
+*       anim4dc_bench <model.a4d|gltf|glb|iqm> [options]
+*
+*   OPTIONS:
+*       --frames <count>      Frames timed per crowd size (default: 500)
+*       --field <units>       Edge of the square field instances are spread over (default: 400)
+*       --cell <units>        Grid cell size (default: ANIM4DC_GRID_CELL_SIZE)
+*       --moving <percent>    Instances that move every frame (default: 5)
+*       --hysteresis <units>  Margin around every LOD band limit (default: the policy's own margins)
+*       --screen <lines>      Pick LOD bands by projected size on a render target this tall (default: distance)
+*
+**********************************************************************************************/
+
+#define ANIM4DC_IMPLEMENTATION
+#include "anim4dc.h"
+
+#define BENCH_CAMERA_DISTANCE   150.0f      // Orbit radius, puts the camera inside the LOD bands of the field
+#define BENCH_WALK_STEP         0.5f        // Max distance a moving instance covers per frame
+
+static const int crowdSizes[] = { 100, 1000, 10000 };
+
+static void PrintUsage(const char *program) {
+    printf("Usage: %s <model.a4d|gltf|glb|iqm> [--frames <count>] [--field <units>] [--cell <units>] [--moving <percent>] [--hysteresis <units>] [--screen <lines>]\n", program);
+}
+
+static float RandomRange(float minValue, float maxValue) {
+    return minValue + (maxValue - minValue) * (float)GetRandomValue(0, 10000) / 10000.0f;
+}
+
+// Load a pre-baked .a4d, or bake the model's animations
+static Anim4dcBakedModel *LoadBenchModel(const char *path) {
+    if (IsFileExtension(path, ".a4d")) return Anim4dcLoadBaked(path);
+    
+    Model model = LoadModel(path);
+    int animationCount = 0;
+    ModelAnimation *animations = LoadModelAnimations(path, &animationCount);
+    
+    Anim4dcBakedModel *baked = NULL;
+    if (model.meshCount > 0 && animationCount > 0) baked = Anim4dcBakeVertexAnimations(model, animations, animationCount);
+    
+    if (animationCount > 0) UnloadModelAnimations(animations, animationCount);
+    UnloadModel(model);
+    return baked;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    int frames = 500;
+    float field = 400.0f;
+    float cellSize = ANIM4DC_GRID_CELL_SIZE;
+    float moving = 5.0f;
+    float hysteresis = -1.0f;
+    int screenLines = 0;
+    
+    for (int i = 2; i < argc; i++) {
+        if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) {
+            frames = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--field") == 0) && (i + 1 < argc)) {
+            field = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--cell") == 0) && (i + 1 < argc)) {
+            cellSize = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--moving") == 0) && (i + 1 < argc)) {
+            moving = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--hysteresis") == 0) && (i + 1 < argc)) {
+            hysteresis = (float)atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--screen") == 0) && (i + 1 < argc)) {
+            screenLines = atoi(argv[++i]);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (frames < 1) frames = 1;
+    
+    // A (hidden) window provides the timer, the frustum aspect ratio and GL for model loading
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(320, 240, "anim4dc_bench");
+    
+    if (!Anim4dcInit()) {
+        CloseWindow();
+        return 1;
+    }
+    
+    Anim4dcBakedModel *baked = LoadBenchModel(argv[1]);
+    if (!baked) {
+        printf("anim4dc_bench: failed to load %s\n", argv[1]);
+        Anim4dcShutdown();
+        CloseWindow();
+        return 1;
+    }
+    if (screenLines > 0) Anim4dcSetLodPolicy(Anim4dcGetScreenSizeLodPolicy(screenLines));
+    if (hysteresis >= 0.0f) Anim4dcSetLodHysteresis(baked, hysteresis, hysteresis, hysteresis, hysteresis);
+    
+    printf("\n%d frames per crowd, %.0f x %.0f field, %.0f unit cells, %.0f%% moving\n", frames, field, field, cellSize, moving);
+    printf("%9s %7s %11s %11s %11s %8s %12s %12s %10s\n", "Instances", "Cells", "Linear(us)", "Arrays(us)", "Grid(us)", "Speedup",
+           "Tests/frame", "Churn/frame", "Mismatches");
+    
+    int result = 0;
+    for (int s = 0; s < (int)(sizeof(crowdSizes) / sizeof(crowdSizes[0])); s++) {
+        int count = crowdSizes[s];
+        
+        // Identical crowds, one classified by each pass
+        Anim4dcModelInstance *linear = (Anim4dcModelInstance *)calloc(count, sizeof(Anim4dcModelInstance));
+        Anim4dcModelInstance *gridded = (Anim4dcModelInstance *)calloc(count, sizeof(Anim4dcModelInstance));
+        Anim4dcInstanceArrays arrays = Anim4dcCreateInstanceArrays(count);
+        Anim4dcSpatialGrid *grid = Anim4dcCreateSpatialGrid(cellSize, count);
+        if (!linear || !gridded || (arrays.capacity == 0) || !grid) {
+            printf("anim4dc_bench: out of memory for %d instances\n", count);
+            free(linear);
+            free(gridded);
+            Anim4dcUnloadInstanceArrays(arrays);
+            Anim4dcUnloadSpatialGrid(grid);
+            result = 1;
+            break;
+        }
+        
+        SetRandomSeed(1234);
+        for (int i = 0; i < count; i++) {
+            linear[i].position = (Vector3){ RandomRange(-field / 2, field / 2), 0.0f, RandomRange(-field / 2, field / 2) };
+            linear[i].scale = RandomRange(0.8f, 1.2f);
+            linear[i].animationIndex = -1;
+        }
+        memcpy(gridded, linear, count * sizeof(Anim4dcModelInstance));
+        Anim4dcLoadInstanceArraysFrom(&arrays, linear, count);
+        Anim4dcBuildSpatialGrid(grid, gridded, count);
+        
+        Camera3D camera = { 0 };
+        camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 45.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+        
+        double linearTime = 0.0;
+        double arraysTime = 0.0;
+        double gridTime = 0.0;
+        long tests = 0;
+        long churn = 0;
+        long mismatches = 0;
+        int movers = (int)(count * moving / 100.0f);
+        
+        for (int f = 0; f < frames; f++) {
+            // Orbit once over the run so every side of the field is seen
+            float angle = 2.0f * PI * f / frames;
+            camera.position = (Vector3){ cosf(angle) * BENCH_CAMERA_DISTANCE, 40.0f, sinf(angle) * BENCH_CAMERA_DISTANCE };
+            
+            // Part of the crowd wanders, the arrays and the grid are told about each move
+            for (int m = 0; m < movers; m++) {
+                int i = GetRandomValue(0, count - 1);
+                linear[i].position.x += RandomRange(-BENCH_WALK_STEP, BENCH_WALK_STEP);
+                linear[i].position.z += RandomRange(-BENCH_WALK_STEP, BENCH_WALK_STEP);
+                arrays.x[i] = linear[i].position.x;
+                arrays.z[i] = linear[i].position.z;
+                gridded[i].position = linear[i].position;
+                Anim4dcMoveGridInstance(grid, gridded, i);
+            }
+            
+            double start = GetTime();
+            Anim4dcUpdateInstanceLOD(baked, linear, count, camera);
+            double linearEnd = GetTime();
+            Anim4dcStats linearStats = Anim4dcGetStats(baked);
+            Anim4dcUpdateInstanceArraysLOD(baked, &arrays, camera);
+            double arraysEnd = GetTime();
+            Anim4dcStats arraysStats = Anim4dcGetStats(baked);
+            Anim4dcUpdateInstanceLODGrid(baked, grid, gridded, camera);
+            double end = GetTime();
+            Anim4dcStats gridStats = Anim4dcGetStats(baked);
+            
+            linearTime += linearEnd - start;
+            arraysTime += arraysEnd - linearEnd;
+            gridTime += end - arraysEnd;
+            tests += gridStats.lodInstanceTests;
+            for (int t = 0; t <= ANIM4DC_LOD_CULLED; t++) {
+                churn += linearStats.lodTransitions[t];
+                if ((linearStats.lodTransitions[t] != arraysStats.lodTransitions[t]) || (linearStats.lodTransitions[t] != gridStats.lodTransitions[t])) {
+                    mismatches++;
+                }
+            }
+            
+            for (int i = 0; i < count; i++) {
+                if ((linear[i].lodLevel != gridded[i].lodLevel) || (linear[i].visible != gridded[i].visible)) mismatches++;
+                if ((linear[i].lodLevel != arrays.lodLevel[i]) || (linear[i].visible != (arrays.visible[i] != 0))) mismatches++;
+            }
+            if ((linearStats.visibleInstances != gridStats.visibleInstances) || (linearStats.culledInstances != gridStats.culledInstances) ||
+                (linearStats.frustumCulledInstances != gridStats.frustumCulledInstances)) {
+                mismatches++;
+            }
+            if ((linearStats.visibleInstances != arraysStats.visibleInstances) || (linearStats.culledInstances != arraysStats.culledInstances) ||
+                (linearStats.frustumCulledInstances != arraysStats.frustumCulledInstances)) {
+                mismatches++;
+            }
+        }
+        
+        // Speedup of the faster of the arrays and grid passes over the linear scan
+        double linearMicros = linearTime * 1e6 / frames;
+        double arraysMicros = arraysTime * 1e6 / frames;
+        double gridMicros = gridTime * 1e6 / frames;
+        double bestMicros = (arraysMicros < gridMicros) ? arraysMicros : gridMicros;
+        printf("%9d %7d %11.2f %11.2f %11.2f %7.2fx %12ld %12.1f %10ld\n", count, Anim4dcGetSpatialGridCellCount(grid), linearMicros, arraysMicros,
+               gridMicros, (bestMicros > 0.0) ? linearMicros / bestMicros : 0.0, tests / frames, (double)churn / frames, mismatches);
+        if (mismatches > 0) result = 1;
+        
+        Anim4dcUnloadSpatialGrid(grid);
+        Anim4dcUnloadInstanceArrays(arrays);
+        free(linear);
+        free(gridded);
+    }
+    
+    Anim4dcUnloadBakedModel(baked);
+    Anim4dcShutdown();
+    CloseWindow();
+    
+    return result;
+}